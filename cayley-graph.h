@@ -0,0 +1,397 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "compact-permutations.h"
+#include "permutation-arena.h"
+
+namespace permutations {
+
+// The Cayley graph of the group generated by some permutations: a vertex per
+// element x and an edge labelled g from x to x ∘ g for every generator g, so
+// the labels along a path from the identity spell a word g_1 ∘ ... ∘ g_m for
+// the element at its end. It is built for groups of 10^7 to 10^8 elements:
+// the elements are numbered by ids and stored back to back with entries as
+// narrow as the degree allows, the edges are ids, and there is no
+// `group_set`. With d generators it takes d × 4 bytes per element for the
+// edges, the elements themselves and, while it is built, 11 to 21 bytes per
+// element for the hash index of the elements.
+//
+// The edges are in CSR form. All vertices have the same out-degree, so the
+// row offsets are implicit, row x starts at x × degree(), and the label of an
+// edge is its column.
+
+namespace cayley_detail {
+
+// Blocks and levels with fewer vertices than this run on the calling thread,
+// starting threads costs more than it saves.
+inline constexpr std::size_t parallel_threshold = 1zu << 12;
+// The group is enumerated in blocks of this many vertices.
+inline constexpr std::size_t block_size = 1zu << 16;
+
+// Runs `f(t)` for every t in [0, number_of_threads), on the calling thread,
+// if there is only one.
+template <typename F> void run_threads(std::size_t number_of_threads, F &&f) {
+    if (number_of_threads <= 1zu) {
+        f(0zu);
+        return;
+    }
+    std::vector<std::jthread> threads{};
+    threads.reserve(number_of_threads);
+    for (std::size_t t = 0; t < number_of_threads; ++t)
+        threads.emplace_back([&f, t] { f(t); });
+}
+
+// The part of [0, count), that thread t of n works on.
+constexpr std::pair<std::size_t, std::size_t>
+chunk(std::size_t count, std::size_t t, std::size_t n) {
+    return {count * t / n, count * (t + 1zu) / n};
+}
+
+template <std::unsigned_integral Entry>
+std::uint64_t hash_entries(std::span<const Entry> perm) {
+    std::uint64_t hash = 0x9e3779b97f4a7c15u;
+    for (const Entry x : perm) {
+        hash = (hash ^ x) * 0xbf58476d1ce4e5b9u;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+// The ids of the elements of an arena by open addressing with linear
+// probing. A slot holds the upper 32 bits of the hash of an element and its
+// id + 1, 0 is empty. The slot of an element only depends on those 32 bits,
+// so neither probing nor growing needs to look at other elements. `find` may
+// run concurrently, `insert` may not.
+template <std::unsigned_integral Entry> class element_index {
+    std::vector<std::uint64_t> m_slots = std::vector<std::uint64_t>(1024);
+    int m_bits = 10; // m_slots.size() == 2^m_bits
+    std::size_t m_size{};
+
+    std::size_t first_slot(std::uint32_t tag) const {
+        return std::size_t{tag} >> (32 - m_bits);
+    }
+    void place(std::uint64_t slot) {
+        const std::size_t mask = m_slots.size() - 1zu;
+        std::size_t i = first_slot(static_cast<std::uint32_t>(slot >> 32));
+        while (m_slots[i] != 0u)
+            i = (i + 1zu) & mask;
+        m_slots[i] = slot;
+    }
+
+  public:
+    std::optional<std::uint32_t>
+    find(const basic_permutation_arena<Entry> &elements,
+         std::span<const Entry> perm, std::uint64_t hash) const {
+        const auto tag = static_cast<std::uint32_t>(hash >> 32);
+        const std::size_t mask = m_slots.size() - 1zu;
+        for (std::size_t i = first_slot(tag);; i = (i + 1zu) & mask) {
+            const std::uint64_t slot = m_slots[i];
+            if (slot == 0u)
+                return std::nullopt;
+            const auto id = static_cast<std::uint32_t>(slot) - 1u;
+            if (slot >> 32 == tag && std::ranges::equal(elements[id], perm))
+                return id;
+        }
+    }
+
+    // Adds element `id`, which must not be in the index.
+    void insert(std::uint32_t id, std::uint64_t hash) {
+        // at most 3/4 full
+        if (4zu * (m_size + 1zu) > 3zu * m_slots.size()) {
+            assert(m_bits < 32);
+            std::vector<std::uint64_t> old(2zu * m_slots.size());
+            std::swap(old, m_slots);
+            ++m_bits;
+            for (const std::uint64_t slot : old)
+                if (slot != 0u)
+                    place(slot);
+        }
+        place((hash & 0xffff'ffff'0000'0000u) | (std::uint64_t{id} + 1u));
+        ++m_size;
+    }
+};
+
+} // namespace cayley_detail
+
+class cayley_graph {
+    compact_permutation_arena m_elements{};
+    // the index of the generator of every column
+    std::vector<std::uint32_t> m_generators{};
+    // row x, i.e. the ids of x ∘ g for every column g, at x × degree()
+    std::vector<std::uint32_t> m_targets{};
+
+    cayley_graph() = default;
+
+    template <std::unsigned_integral Entry>
+    bool enumerate(basic_permutation_arena<Entry> &elements,
+                   const permutation_arena &generators, std::size_t max_order,
+                   std::size_t number_of_threads);
+
+  public:
+    // Vertices of the Cayley graph and the group, see `create`.
+    static constexpr std::size_t max_order =
+        std::numeric_limits<std::uint32_t>::max() - 1zu;
+
+    // The Cayley graph of the group generated by `generators`, with the
+    // identity as element 0 and the elements in breadth-first order from
+    // it. Generators, that are the identity or equal to an earlier one, get
+    // no column, because their edges would be loops or parallel edges.
+    // Returns std::nullopt, if a generator is no permutation of
+    // `generators.places()` points, or if the group has more than
+    // `order_limit` elements.
+    [[nodiscard]] static std::optional<cayley_graph>
+    create(const permutation_arena &generators,
+           std::size_t order_limit = max_order,
+           std::size_t number_of_threads = std::thread::hardware_concurrency());
+
+    std::size_t size() const { return m_elements.size(); }
+    std::size_t places() const { return m_elements.places(); }
+    std::size_t degree() const { return m_generators.size(); }
+    const compact_permutation_arena &elements() const { return m_elements; }
+
+    // The ids of x ∘ g, one for every column.
+    std::span<const std::uint32_t> edges(std::uint32_t x) const {
+        return std::span{m_targets}.subspan(std::size_t{x} * degree(),
+                                            degree());
+    }
+    // The index in the generators passed to `create` of `column`.
+    std::uint32_t generator_of_column(std::size_t column) const {
+        return m_generators[column];
+    }
+};
+
+// Vertices are found level by level; every level, that is large enough, is
+// split among the threads.
+template <std::unsigned_integral Entry>
+bool cayley_graph::enumerate(basic_permutation_arena<Entry> &elements,
+                             const permutation_arena &generators,
+                             std::size_t max_order,
+                             std::size_t number_of_threads) {
+    const std::size_t places = generators.places();
+    const std::size_t degree = m_generators.size();
+    basic_permutation_arena<Entry> columns(places, degree);
+    for (std::size_t column = 0; column < degree; ++column)
+        convert_into(columns.slot(column), generators[m_generators[column]]);
+
+    cayley_detail::element_index<Entry> index{};
+    const auto identity = elements.append();
+    for (std::size_t i = 0; i < places; ++i)
+        identity[i] = static_cast<Entry>(i);
+    index.insert(0u, cayley_detail::hash_entries(elements[0]));
+
+    // the products, that were not in the index yet, of every thread
+    struct candidates {
+        basic_permutation_arena<Entry> products;
+        std::vector<std::size_t> edges{};
+        std::vector<std::uint64_t> hashes{};
+    };
+    for (std::size_t lo = 0; lo < elements.size();) {
+        const std::size_t hi =
+            std::min(elements.size(), lo + cayley_detail::block_size);
+        m_targets.resize(hi * degree);
+        const std::size_t threads =
+            hi - lo < cayley_detail::parallel_threshold
+                ? 1zu
+                : std::max(number_of_threads, 1zu);
+        std::vector<candidates> found(
+            threads,
+            candidates{.products = basic_permutation_arena<Entry>(places)});
+        cayley_detail::run_threads(threads, [&](std::size_t t) {
+            auto &mine = found[t];
+            std::vector<Entry> product(places);
+            const auto [first, last] =
+                cayley_detail::chunk(hi - lo, t, threads);
+            for (std::size_t x = lo + first; x < lo + last; ++x) {
+                for (std::size_t column = 0; column < degree; ++column) {
+                    [[maybe_unused]] const bool ok = compose_into(
+                        std::span{product}, elements[x], columns[column]);
+                    assert(ok);
+                    const std::span<const Entry> p{product};
+                    const auto hash = cayley_detail::hash_entries(p);
+                    if (const auto id = index.find(elements, p, hash)) {
+                        m_targets[x * degree + column] = *id;
+                        continue;
+                    }
+                    std::ranges::copy(p, mine.products.append().begin());
+                    mine.edges.push_back(x * degree + column);
+                    mine.hashes.push_back(hash);
+                }
+            }
+        });
+
+        // In the order of the edges, so the ids do not depend on the
+        // number of threads.
+        for (const auto &mine : found) {
+            for (std::size_t i = 0; i < mine.edges.size(); ++i) {
+                const auto p = mine.products[i];
+                auto id = index.find(elements, p, mine.hashes[i]);
+                if (!id) {
+                    if (elements.size() >= max_order)
+                        return false;
+                    id = static_cast<std::uint32_t>(elements.size());
+                    std::ranges::copy(p, elements.append().begin());
+                    index.insert(*id, mine.hashes[i]);
+                }
+                m_targets[mine.edges[i]] = *id;
+            }
+        }
+        lo = hi;
+    }
+    return true;
+}
+
+inline std::optional<cayley_graph>
+cayley_graph::create(const permutation_arena &generators,
+                     std::size_t order_limit, std::size_t number_of_threads) {
+    const std::size_t places = generators.places();
+    if (places == 0zu || generators.size() > max_order)
+        return std::nullopt;
+    for (std::size_t g = 0; g < generators.size(); ++g)
+        if (!entries_are_permutation(generators[g]))
+            return std::nullopt;
+
+    cayley_graph ret{};
+    for (std::size_t g = 0; g < generators.size(); ++g) {
+        const auto perm = generators[g];
+        bool is_identity = true;
+        for (std::size_t i = 0; i < places; ++i)
+            is_identity = is_identity && perm[i] == i;
+        const bool is_repeated = std::ranges::any_of(
+            ret.m_generators, [&](std::uint32_t earlier) {
+                return std::ranges::equal(generators[earlier], perm);
+            });
+        if (!is_identity && !is_repeated)
+            ret.m_generators.push_back(static_cast<std::uint32_t>(g));
+    }
+
+    ret.m_elements = compact_permutation_arena(places);
+    const bool ok = ret.m_elements.visit([&](auto &elements) {
+        return ret.enumerate(elements, generators,
+                             std::min(order_limit, max_order),
+                             number_of_threads);
+    });
+    if (!ok)
+        return std::nullopt;
+    ret.m_targets.shrink_to_fit();
+    return ret;
+}
+
+// The word metric of a Cayley graph: the distances from one element, see
+// `word_metrics_of`.
+struct word_metrics {
+    static constexpr std::uint32_t not_reached =
+        std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t root{};
+    // the number of elements of every word length, starting with the root;
+    // its size is the diameter + 1
+    std::vector<std::uint64_t> distribution{};
+    // the vertex every element was reached from, the smallest one of the
+    // previous level; the root for the root, or `not_reached`
+    std::vector<std::uint32_t> parent{};
+
+    std::size_t diameter() const { return distribution.size() - 1zu; }
+    bool contains(std::uint32_t x) const { return parent[x] != not_reached; }
+
+    // The indices of generators g_1, ..., g_m of a shortest word with x =
+    // root ∘ g_1 ∘ ... ∘ g_m. Empty for the root, std::nullopt, if x is not
+    // reached.
+    std::optional<std::vector<std::uint32_t>>
+    shortest_word(const cayley_graph &graph, std::uint32_t x) const {
+        if (!contains(x))
+            return std::nullopt;
+        std::vector<std::uint32_t> word{};
+        for (; x != root; x = parent[x]) {
+            const auto edges = graph.edges(parent[x]);
+            const auto column = std::ranges::find(edges, x) - edges.begin();
+            word.push_back(graph.generator_of_column(
+                static_cast<std::size_t>(column)));
+        }
+        std::ranges::reverse(word);
+        return word;
+    }
+};
+
+// Breadth-first search from `root`, level by level. The vertices of a level
+// are split among the threads, that claim the vertices of the next level in
+// a bitmap. The parent of a vertex is the smallest one, that reaches it, so
+// the result does not depend on the number of threads.
+inline word_metrics
+word_metrics_of(const cayley_graph &graph, std::uint32_t root = 0u,
+                std::size_t number_of_threads =
+                    std::thread::hardware_concurrency()) {
+    const std::size_t size = graph.size();
+    word_metrics ret{.root = root};
+    if (root >= size)
+        return ret;
+    ret.parent.assign(size, word_metrics::not_reached);
+    // The vertices of the previous levels, which are only read during a
+    // level, and those plus the ones of the next level found so far.
+    std::vector<std::uint64_t> visited((size + 63zu) / 64zu);
+    std::vector<std::uint64_t> claimed(visited.size());
+    auto set = [](std::vector<std::uint64_t> &bits, std::uint32_t x) {
+        const std::uint64_t bit = std::uint64_t{1} << (x % 64u);
+        return (std::atomic_ref{bits[x / 64u]}.fetch_or(
+                    bit, std::memory_order_relaxed) &
+                bit) != 0u;
+    };
+
+    std::vector<std::uint32_t> frontier{root};
+    ret.parent[root] = root;
+    set(visited, root);
+    set(claimed, root);
+    while (!frontier.empty()) {
+        ret.distribution.push_back(frontier.size());
+        const std::size_t threads =
+            frontier.size() < cayley_detail::parallel_threshold
+                ? 1zu
+                : std::max(number_of_threads, 1zu);
+        std::vector<std::vector<std::uint32_t>> next(threads);
+        cayley_detail::run_threads(threads, [&](std::size_t t) {
+            const auto [first, last] =
+                cayley_detail::chunk(frontier.size(), t, threads);
+            for (std::size_t i = first; i < last; ++i) {
+                const std::uint32_t x = frontier[i];
+                for (const std::uint32_t y : graph.edges(x)) {
+                    if ((visited[y / 64u] >> (y % 64u)) & 1u)
+                        continue;
+                    std::atomic_ref parent{ret.parent[y]};
+                    std::uint32_t old = parent.load(std::memory_order_relaxed);
+                    while (x < old && !parent.compare_exchange_weak(
+                                          old, x, std::memory_order_relaxed))
+                        ;
+                    if (!set(claimed, y))
+                        next[t].push_back(y);
+                }
+            }
+        });
+
+        frontier.clear();
+        for (const auto &found : next)
+            frontier.insert(frontier.end(), found.begin(), found.end());
+        const std::size_t mark_threads =
+            frontier.size() < cayley_detail::parallel_threshold
+                ? 1zu
+                : std::max(number_of_threads, 1zu);
+        cayley_detail::run_threads(mark_threads, [&](std::size_t t) {
+            const auto [first, last] =
+                cayley_detail::chunk(frontier.size(), t, mark_threads);
+            for (std::size_t i = first; i < last; ++i)
+                set(visited, frontier[i]);
+        });
+    }
+    return ret;
+}
+
+} // namespace permutations
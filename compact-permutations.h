@@ -0,0 +1,178 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "permutation-arena.h"
+
+namespace permutations {
+
+// Permutations with entries of 8, 16 or 32 bits. `Permutation` uses 32 bit
+// entries, which is four times the memory that S_n needs for n <= 256:
+// an arena of all of S_10 would take 36 MB with 8 bit entries instead of
+// 145 MB. The kernels below take spans of any entry type, also mixed ones,
+// so they work on `basic_permutation`s, arena slots and compact arenas alike.
+
+// Can `Entry` hold the points 0 .. places - 1?
+template <std::unsigned_integral Entry>
+constexpr bool entry_fits(std::size_t places) {
+    return places == 0zu ||
+           places - 1zu <= std::size_t{std::numeric_limits<Entry>::max()};
+}
+
+// The narrowest entry width in bytes for permutations of `places` points.
+constexpr std::size_t entry_width_for(std::size_t places) {
+    if (entry_fits<std::uint8_t>(places))
+        return sizeof(std::uint8_t);
+    if (entry_fits<std::uint16_t>(places))
+        return sizeof(std::uint16_t);
+    return sizeof(std::uint32_t);
+}
+
+// a ∘ b, i.e. out[i] = a[b[i]]. `out` must not overlap with `a` or `b`.
+// Returns false, if the sizes differ or `b` maps out of range. This is the
+// kernel of `compose_permutations_into` for permutations below
+// `blocked_permutation_threshold`.
+template <std::unsigned_integral Out, std::unsigned_integral A,
+          std::unsigned_integral B>
+[[nodiscard]] constexpr bool compose_into(std::span<Out> out,
+                                          std::span<const A> a,
+                                          std::span<const B> b) {
+    const std::size_t size = a.size();
+    if (b.size() != size || out.size() != size)
+        return false;
+    for (std::size_t i = 0; i < size; ++i) {
+        if (std::cmp_greater_equal(b[i], size))
+            return false;
+        out[i] = static_cast<Out>(a[b[i]]);
+    }
+    return true;
+}
+
+// The inverse of `a`, which has to be a permutation. `out` must not overlap
+// with `a`.
+template <std::unsigned_integral Out, std::unsigned_integral A>
+constexpr void inverse_into(std::span<Out> out, std::span<const A> a) {
+    assert(out.size() == a.size());
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        assert(std::cmp_less(a[i], a.size()));
+        out[a[i]] = static_cast<Out>(i);
+    }
+}
+
+// Copies `a` into entries of another width, which have to fit.
+template <std::unsigned_integral Out, std::unsigned_integral A>
+constexpr void convert_into(std::span<Out> out, std::span<const A> a) {
+    assert(out.size() == a.size() && entry_fits<Out>(a.size()));
+    std::ranges::transform(a, out.begin(),
+                           [](A x) { return static_cast<Out>(x); });
+}
+
+// True, if `a` is a bijection of {0, ..., size-1}. Every image sets one bit
+// of a bitmap; that works without a branch per element, and it is a
+// bijection iff all images are in range and no bit was set twice, i.e. the
+// popcount of the bitmap is the size.
+template <std::unsigned_integral A>
+bool entries_are_permutation(std::span<const A> a) {
+    const std::size_t size = a.size();
+    std::uint64_t in_range = 1;
+    if (size <= 64zu) {
+        std::uint64_t bits = 0;
+        for (const A image : a) {
+            in_range &= image < size;
+            bits |= std::uint64_t{1} << (image & 63u);
+        }
+        return in_range != 0u && std::cmp_equal(std::popcount(bits), size);
+    }
+    std::vector<std::uint64_t> bits((size + 63zu) / 64zu);
+    for (const A image : a) {
+        in_range &= image < size;
+        const std::size_t clamped = image < size ? image : 0zu;
+        bits[clamped / 64zu] |= std::uint64_t{1} << (clamped % 64zu);
+    }
+    std::size_t count = 0;
+    for (const auto word : bits)
+        count += static_cast<std::size_t>(std::popcount(word));
+    return in_range != 0u && count == size;
+}
+
+// An arena of permutations, whose entries are as narrow as their degree
+// allows, see `entry_width_for`. The generic algorithms get the arena of the
+// actual width through `visit`.
+class compact_permutation_arena {
+    std::variant<basic_permutation_arena<std::uint8_t>,
+                 basic_permutation_arena<std::uint16_t>,
+                 basic_permutation_arena<std::uint32_t>>
+        m_arena{};
+
+  public:
+    compact_permutation_arena() = default;
+    explicit compact_permutation_arena(std::size_t places,
+                                       std::size_t count = 0) {
+        switch (entry_width_for(places)) {
+        case sizeof(std::uint8_t):
+            m_arena.emplace<basic_permutation_arena<std::uint8_t>>(places,
+                                                                   count);
+            break;
+        case sizeof(std::uint16_t):
+            m_arena.emplace<basic_permutation_arena<std::uint16_t>>(places,
+                                                                    count);
+            break;
+        default:
+            m_arena.emplace<basic_permutation_arena<std::uint32_t>>(places,
+                                                                    count);
+        }
+    }
+
+    // Calls `f` with the `basic_permutation_arena` of the actual width.
+    template <typename F> decltype(auto) visit(F &&f) {
+        return std::visit(std::forward<F>(f), m_arena);
+    }
+    template <typename F> decltype(auto) visit(F &&f) const {
+        return std::visit(std::forward<F>(f), m_arena);
+    }
+
+    std::size_t places() const {
+        return visit([](const auto &arena) { return arena.places(); });
+    }
+    std::size_t size() const {
+        return visit([](const auto &arena) { return arena.size(); });
+    }
+    std::size_t entry_width() const {
+        return visit([]<typename A>(const A &) {
+            return sizeof(typename A::entry_type);
+        });
+    }
+    std::size_t size_bytes() const {
+        return visit([](const auto &arena) {
+            return arena.entries().size_bytes();
+        });
+    }
+    void resize(std::size_t count) {
+        visit([&](auto &arena) { arena.resize(count); });
+    }
+    void reserve(std::size_t count) {
+        visit([&](auto &arena) { arena.reserve(count); });
+    }
+
+    // Copies permutation `index` into `out`, of any width, that fits.
+    template <std::unsigned_integral Out>
+    void get(std::size_t index, std::span<Out> out) const {
+        visit([&](const auto &arena) { convert_into(out, arena[index]); });
+    }
+    // Sets permutation `index` to `perm`.
+    template <std::unsigned_integral In>
+    void set(std::size_t index, std::span<const In> perm) {
+        visit([&](auto &arena) { convert_into(arena.slot(index), perm); });
+    }
+};
+
+} // namespace permutations
@@ -0,0 +1,439 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace permutations {
+
+// Unsigned integers of arbitrary size, with just the operations needed to
+// count permutations exactly (100! has 158 digits).
+class big_uint {
+    // little-endian, without leading zero limbs; zero is the empty vector
+    std::vector<std::uint32_t> m_limbs{};
+
+    void trim() {
+        while (!m_limbs.empty() && m_limbs.back() == 0u)
+            m_limbs.pop_back();
+    }
+
+  public:
+    big_uint() = default;
+    big_uint(std::uint64_t value) {
+        for (; value != 0u; value >>= 32)
+            m_limbs.push_back(static_cast<std::uint32_t>(value));
+    }
+
+    // from little-endian 32 bit limbs
+    explicit big_uint(std::span<const std::uint32_t> limbs)
+        : m_limbs(limbs.begin(), limbs.end()) {
+        trim();
+    }
+
+    bool is_zero() const { return m_limbs.empty(); }
+    std::span<const std::uint32_t> limbs() const { return m_limbs; }
+
+    big_uint &operator+=(const big_uint &other) {
+        if (m_limbs.size() < other.m_limbs.size())
+            m_limbs.resize(other.m_limbs.size());
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < m_limbs.size(); ++i) {
+            if (i >= other.m_limbs.size() && carry == 0u)
+                break;
+            carry += m_limbs[i];
+            if (i < other.m_limbs.size())
+                carry += other.m_limbs[i];
+            m_limbs[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        if (carry != 0u)
+            m_limbs.push_back(static_cast<std::uint32_t>(carry));
+        return *this;
+    }
+
+    big_uint &operator*=(std::uint32_t factor) {
+        std::uint64_t carry = 0;
+        for (auto &limb : m_limbs) {
+            carry += std::uint64_t{limb} * factor;
+            limb = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        if (carry != 0u)
+            m_limbs.push_back(static_cast<std::uint32_t>(carry));
+        trim();
+        return *this;
+    }
+
+    friend big_uint operator*(const big_uint &a, const big_uint &b) {
+        big_uint ret{};
+        if (a.is_zero() || b.is_zero())
+            return ret;
+        ret.m_limbs.assign(a.m_limbs.size() + b.m_limbs.size(), 0u);
+        for (std::size_t i = 0; i < a.m_limbs.size(); ++i) {
+            std::uint64_t carry = 0;
+            for (std::size_t j = 0; j < b.m_limbs.size(); ++j) {
+                carry += std::uint64_t{a.m_limbs[i]} * b.m_limbs[j] +
+                         ret.m_limbs[i + j];
+                ret.m_limbs[i + j] = static_cast<std::uint32_t>(carry);
+                carry >>= 32;
+            }
+            ret.m_limbs[i + b.m_limbs.size()] =
+                static_cast<std::uint32_t>(carry);
+        }
+        ret.trim();
+        return ret;
+    }
+
+    // Divides in place, returns the remainder.
+    std::uint32_t divide(std::uint32_t divisor) {
+        assert(divisor != 0u);
+        std::uint64_t remainder = 0;
+        for (std::size_t i = m_limbs.size(); i-- > 0zu;) {
+            remainder = (remainder << 32) | m_limbs[i];
+            m_limbs[i] = static_cast<std::uint32_t>(remainder / divisor);
+            remainder %= divisor;
+        }
+        trim();
+        return static_cast<std::uint32_t>(remainder);
+    }
+
+    std::optional<std::uint64_t> to_uint64() const {
+        if (m_limbs.size() > 2zu)
+            return std::nullopt;
+        std::uint64_t ret = 0;
+        for (std::size_t i = m_limbs.size(); i-- > 0zu;)
+            ret = (ret << 32) | m_limbs[i];
+        return ret;
+    }
+
+    std::string to_string() const {
+        if (is_zero())
+            return "0";
+        // nine decimal digits at a time
+        big_uint rest = *this;
+        std::vector<std::uint32_t> groups{};
+        while (!rest.is_zero())
+            groups.push_back(rest.divide(1'000'000'000u));
+        std::string ret = std::to_string(groups.back());
+        for (std::size_t i = groups.size() - 1zu; i-- > 0zu;) {
+            const std::string group = std::to_string(groups[i]);
+            ret.append(9zu - group.size(), '0');
+            ret += group;
+        }
+        return ret;
+    }
+
+    friend bool operator==(const big_uint &, const big_uint &) = default;
+    friend std::strong_ordering operator<=>(const big_uint &a,
+                                            const big_uint &b) {
+        if (auto c = a.m_limbs.size() <=> b.m_limbs.size(); c != 0)
+            return c;
+        for (std::size_t i = a.m_limbs.size(); i-- > 0zu;)
+            if (auto c = a.m_limbs[i] <=> b.m_limbs[i]; c != 0)
+                return c;
+        return std::strong_ordering::equal;
+    }
+};
+
+inline big_uint big_factorial(std::uint32_t n) {
+    big_uint ret{1u};
+    for (std::uint32_t i = 2; i <= n; ++i)
+        ret *= i;
+    return ret;
+}
+
+// Closed-form statistics of the symmetric group S_n. Two permutations are
+// conjugate iff they have the same cycle type, a partition of n, and all
+// permutations of one cycle type share their order, sign and the size of their
+// centralizer. So everything here works on the partitions of n, or on
+// recurrences over the cycle lengths, and never enumerates the n! elements.
+
+// Statistics of one cycle type, i.e. of one conjugacy class of S_n.
+struct cycle_type_statistics {
+    // non-increasing, fixed points included, like `cycle_type`
+    std::vector<std::uint32_t> cycle_lengths{};
+    // lcm of the cycle lengths
+    std::uint64_t element_order{};
+    bool even{};
+    // prod k^m_k * m_k!, if the cycle length k occurs m_k times
+    big_uint centralizer_order{};
+    // n! / centralizer_order
+    big_uint class_size{};
+};
+
+// Returns std::nullopt, if `cycle_lengths` is not non-increasing or contains
+// a zero, or if the element order does not fit into 64 bits.
+[[nodiscard]] inline std::optional<cycle_type_statistics>
+statistics_of_cycle_type(std::span<const std::uint32_t> cycle_lengths) {
+    if (std::ranges::find(cycle_lengths, 0u) != cycle_lengths.end() ||
+        !std::ranges::is_sorted(cycle_lengths, std::ranges::greater{}))
+        return std::nullopt;
+
+    cycle_type_statistics ret{};
+    ret.cycle_lengths.assign(cycle_lengths.begin(), cycle_lengths.end());
+    std::uint64_t n = 0;
+    std::uint64_t order = 1;
+    for (const std::uint32_t k : cycle_lengths) {
+        n += k;
+        const std::uint64_t g = std::gcd(order, std::uint64_t{k});
+        if (__builtin_mul_overflow(order / g, std::uint64_t{k}, &order))
+            return std::nullopt;
+    }
+    if (n > std::numeric_limits<std::uint32_t>::max())
+        return std::nullopt;
+    ret.element_order = order;
+    ret.even = (n - cycle_lengths.size()) % 2u == 0u;
+
+    // Dividing n! by the factors of the centralizer order one by one stays
+    // exact, because every partial product divides the centralizer order,
+    // which divides n!.
+    ret.centralizer_order = big_uint{1u};
+    ret.class_size = big_factorial(static_cast<std::uint32_t>(n));
+    for (std::size_t i = 0; i < cycle_lengths.size();) {
+        const std::uint32_t k = cycle_lengths[i];
+        std::uint32_t multiplicity = 0;
+        for (; i < cycle_lengths.size() && cycle_lengths[i] == k; ++i) {
+            ++multiplicity;
+            ret.centralizer_order *= k;
+            ret.centralizer_order *= multiplicity;
+            [[maybe_unused]] auto r1 = ret.class_size.divide(k);
+            [[maybe_unused]] auto r2 = ret.class_size.divide(multiplicity);
+            assert(r1 == 0u && r2 == 0u);
+        }
+    }
+    return ret;
+}
+
+// Invokes `call_back` with the statistics of every cycle type of S_`n`, in
+// reverse lexicographic order of the partitions, i.e. {n} first and
+// {1, ..., 1} last. There are p(n) of them, which is 190569292 for n = 100,
+// so for large n prefer `order_histogram`. If `call_back` returns bool,
+// `false` stops the walk and makes this function return `false`; so does an
+// element order, that does not fit into 64 bits.
+template <typename CallBack>
+    requires std::invocable<CallBack &, const cycle_type_statistics &>
+[[nodiscard]] bool for_each_cycle_type(std::uint32_t n, CallBack &&call_back) {
+    if (n == 0u)
+        return true;
+    std::vector<std::uint32_t> parts{n};
+    while (true) {
+        auto statistics = statistics_of_cycle_type(parts);
+        if (!statistics)
+            return false;
+        if constexpr (std::same_as<std::invoke_result_t<
+                                       CallBack &,
+                                       const cycle_type_statistics &>,
+                                   bool>) {
+            if (!call_back(std::as_const(*statistics)))
+                return false;
+        } else {
+            call_back(std::as_const(*statistics));
+        }
+
+        // next partition: decrease the last part, that is larger than one,
+        // and spread the freed ones over parts of at most its new size
+        std::uint32_t freed = 0;
+        while (!parts.empty() && parts.back() == 1u) {
+            parts.pop_back();
+            ++freed;
+        }
+        if (parts.empty())
+            return true;
+        const std::uint32_t k = --parts.back();
+        ++freed;
+        for (; freed > k; freed -= k)
+            parts.push_back(k);
+        if (freed != 0u)
+            parts.push_back(freed);
+    }
+}
+
+// Number of elements of S_n of one order.
+struct order_histogram_entry {
+    std::uint64_t order{};
+    big_uint count{};
+};
+
+// The exact number of elements of every order in S_`n`, sorted by order.
+// Orders, that no element has, are left out. Needs no enumeration of
+// partitions: with a(m, o) permutations of m points of order o, the cycle of
+// one point has length k in (m-1)!/(m-k)! ways, so
+//   a(m, o) = sum_k (m-1)!/(m-k)! * a(m-k, o') over lcm(o', k) = o.
+// Scaled to f(m, o) = n!/m! * a(m, o), which are integers, this becomes
+//   f(m, o) = (sum_k f(m-k, o')) / m,
+// i.e. only additions and one small exact division per entry. For n = 100
+// there are 18663 orders and about 5.7 million additions.
+// Returns std::nullopt, if an order does not fit into 64 bits.
+[[nodiscard]] inline std::optional<std::vector<order_histogram_entry>>
+order_histogram(std::uint32_t n) {
+    // All numbers have the same number of 64 bit limbs, enough for n * n!,
+    // and are stored back to back.
+    const big_uint n_factorial = big_factorial(n);
+    const std::size_t width = n_factorial.limbs().size() / 2zu + 2zu;
+    struct level {
+        std::vector<std::uint64_t> orders{};
+        std::vector<std::uint64_t> limbs{}; // width per order
+    };
+    std::vector<level> scaled(std::size_t{n} + 1zu);
+    scaled[0].orders.push_back(1u);
+    scaled[0].limbs.resize(width);
+    for (std::size_t i = 0; i < n_factorial.limbs().size(); ++i)
+        scaled[0].limbs[i / 2zu] |= std::uint64_t{n_factorial.limbs()[i]}
+                                    << (32zu * (i % 2zu));
+
+    // gcd(k, r) for r < k <= n; the orders stay below 2^32 for n up to
+    // several hundred, where this replaces the 64 bit gcd of every addition
+    std::vector<std::uint32_t> small_gcd((std::size_t{n} + 1zu) *
+                                         (std::size_t{n} + 1zu));
+    for (std::uint32_t k = 1; k <= n; ++k)
+        for (std::uint32_t r = 0; r < k; ++r)
+            small_gcd[k * (n + 1u) + r] = std::gcd(k, r);
+
+    // open addressing from order to its index in the level; kept at most half
+    // full, one lookup per addition
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> slots{};
+    auto find_slot = [&slots](std::uint64_t order) -> std::size_t {
+        const std::size_t mask = slots.size() - 1zu;
+        std::size_t slot = ((order * 0x9e3779b97f4a7c15u) >> 17) & mask;
+        while (slots[slot].first != 0u && slots[slot].first != order)
+            slot = (slot + 1zu) & mask;
+        return slot;
+    };
+    for (std::uint32_t m = 1; m <= n; ++m) {
+        auto &current = scaled[m];
+        // every order of m-1 points is one of m points, too
+        slots.assign(std::bit_ceil(4zu * scaled[m - 1].orders.size() + 64zu),
+                     {0u, 0u});
+
+        for (std::uint32_t k = 1; k <= m; ++k) {
+            const auto &source = scaled[m - k];
+            for (std::size_t i = 0; i < source.orders.size(); ++i) {
+                const std::uint64_t order = source.orders[i];
+                std::uint64_t new_order{};
+                if (order <= std::numeric_limits<std::uint32_t>::max()) {
+                    const auto order32 = static_cast<std::uint32_t>(order);
+                    new_order = std::uint64_t{
+                                    order32 / small_gcd[k * (n + 1u) +
+                                                        order32 % k]} *
+                                k;
+                } else if (__builtin_mul_overflow(
+                               order / std::gcd(order % k, std::uint64_t{k}),
+                               std::uint64_t{k}, &new_order)) {
+                    return std::nullopt;
+                }
+                std::size_t slot = find_slot(new_order);
+                if (slots[slot].first == 0u) {
+                    slots[slot] = {
+                        new_order,
+                        static_cast<std::uint32_t>(current.orders.size())};
+                    current.orders.push_back(new_order);
+                    current.limbs.resize(current.limbs.size() + width);
+                    if (2zu * current.orders.size() > slots.size()) {
+                        slots.assign(2zu * slots.size(), {0u, 0u});
+                        for (std::uint32_t j = 0; j < current.orders.size();
+                             ++j)
+                            slots[find_slot(current.orders[j])] = {
+                                current.orders[j], j};
+                        slot = find_slot(new_order);
+                    }
+                }
+                std::uint64_t *to =
+                    current.limbs.data() + width * slots[slot].second;
+                const std::uint64_t *from = source.limbs.data() + width * i;
+                unsigned char carry = 0;
+                for (std::size_t l = 0; l < width; ++l) {
+                    const unsigned __int128 sum =
+                        static_cast<unsigned __int128>(to[l]) + from[l] +
+                        carry;
+                    to[l] = static_cast<std::uint64_t>(sum);
+                    carry = static_cast<unsigned char>(sum >> 64);
+                }
+                assert(carry == 0u);
+            }
+        }
+        // exact division by m of every number
+        for (std::size_t number = 0; number < current.orders.size();
+             ++number) {
+            std::uint64_t *limbs = current.limbs.data() + width * number;
+            // in 32 bit halves, which keeps the divisions native
+            std::uint64_t remainder = 0;
+            for (std::size_t l = width; l-- > 0zu;) {
+                remainder = (remainder << 32) | (limbs[l] >> 32);
+                const std::uint64_t high = remainder / m;
+                remainder = ((remainder % m) << 32) | (limbs[l] & 0xffffffffu);
+                limbs[l] = (high << 32) | (remainder / m);
+                remainder %= m;
+            }
+            assert(remainder == 0u);
+        }
+    }
+
+    const auto &counts = scaled[n];
+    std::vector<order_histogram_entry> ret{};
+    ret.reserve(counts.orders.size());
+    std::vector<std::uint32_t> limbs(2zu * width);
+    for (std::size_t i = 0; i < counts.orders.size(); ++i) {
+        for (std::size_t l = 0; l < 2zu * width; ++l)
+            limbs[l] = static_cast<std::uint32_t>(
+                counts.limbs[width * i + l / 2zu] >> (32zu * (l % 2zu)));
+        ret.push_back(order_histogram_entry{.order = counts.orders[i],
+                                            .count = big_uint{limbs}});
+    }
+    std::ranges::sort(ret, {}, &order_histogram_entry::order);
+    return ret;
+}
+
+// The number of elements of every order in the alternating group A_`n`,
+// sorted by order, like `order_histogram`. Sums the even cycle types, so it
+// walks the p(n) partitions of n.
+[[nodiscard]] inline std::optional<std::vector<order_histogram_entry>>
+alternating_order_histogram(std::uint32_t n) {
+    std::map<std::uint64_t, big_uint> counts{};
+    const bool ok = for_each_cycle_type(
+        n, [&](const cycle_type_statistics &statistics) {
+            if (statistics.even)
+                counts[statistics.element_order] += statistics.class_size;
+        });
+    if (!ok)
+        return std::nullopt;
+    std::vector<order_histogram_entry> ret{};
+    // S_0 has no partitions, but the identity
+    if (n == 0u)
+        ret.push_back(
+            order_histogram_entry{.order = 1u, .count = big_uint{1u}});
+    for (auto &[order, count] : counts)
+        ret.push_back(
+            order_histogram_entry{.order = order, .count = std::move(count)});
+    return ret;
+}
+
+} // namespace permutations
+
+template <> struct std::formatter<permutations::big_uint, char> {
+    template <class ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext &ctx) {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it != '}')
+            throw std::format_error("Invalid format args for big_uint.");
+        return it;
+    }
+
+    template <typename FmtContext>
+    FmtContext::iterator format(const permutations::big_uint &number,
+                                FmtContext &ctx) const {
+        return std::ranges::copy(number.to_string(), ctx.out()).out;
+    }
+};
@@ -39,6 +39,28 @@ template <group_config_c group_config_t>
 std::optional<std::string>
     get_other_representation(typename group_config_t::element_view_type);
 
+// A config, that is a class template and so can not specialize the function
+// templates above partially, implements them as static members instead,
+// `identity`, `compose` and `other_representation`; the general templates
+// forward to those.
+template<group_config_c group_config_type>
+typename group_config_type::element_type get_identity(group_config_type g) {
+    return group_config_type::identity(g);
+}
+
+template<group_config_c group_config_t>
+std::optional<typename group_config_t::element_type>
+compose_permutations(typename group_config_t::element_view_type a,
+                     typename group_config_t::element_view_type b) {
+    return group_config_t::compose(a, b);
+}
+
+template <group_config_c group_config_t>
+std::optional<std::string>
+get_other_representation(typename group_config_t::element_view_type a) {
+    return group_config_t::other_representation(a);
+}
+
 template <group_config_c group_config_t>
 using group_set = std::set<typename group_config_t::element_type,
                            typename group_config_t::compare_type>;
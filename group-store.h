@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "permutation-arena.h"
+
+namespace permutations {
+
+// A directory of generated groups, so that a group is only generated once,
+// not once per run. Every group is a file named by the hash of its key, the
+// group config and its canonical generators. Files are written to a
+// temporary name and renamed, so a reader never sees a half written file and
+// needs no lock; of two writers of the same group the last one wins.
+//
+// File layout, all integers little-endian:
+//   "PGS1", u32 key size, the key, u32 places, u32 count, u32 flags,
+//   count × places u32 elements, [count u32 orders], [count × count u32
+//   products], u64 FNV-1a hash of all the bytes before it.
+// The flags tell, which of the optional parts are there.
+
+// A group as it is stored. The elements are in the order of the `group_set`,
+// so the ids of the product table are their indices.
+struct stored_group {
+    permutation_arena elements{};
+    std::vector<std::uint32_t> orders{};   // empty, or one per element
+    std::vector<std::uint32_t> products{}; // empty, or the ids of a ∘ b
+};
+
+namespace store_detail {
+
+inline constexpr char magic[] = {'P', 'G', 'S', '1'};
+inline constexpr std::uint32_t has_orders = 1u;
+inline constexpr std::uint32_t has_products = 2u;
+
+constexpr std::uint64_t fnv1a(std::span<const unsigned char> bytes,
+                              std::uint64_t hash = 0xcbf29ce484222325u) {
+    for (const unsigned char byte : bytes) {
+        hash ^= byte;
+        hash *= 0x100000001b3u;
+    }
+    return hash;
+}
+
+inline void append_u32(std::vector<unsigned char> &out, std::uint32_t value) {
+    for (int byte = 0; byte < 4; ++byte)
+        out.push_back(static_cast<unsigned char>(value >> (8 * byte)));
+}
+
+// Reads the file front to back; every read fails once one has failed.
+class reader {
+    std::span<const unsigned char> m_bytes;
+    bool m_ok = true;
+
+  public:
+    explicit reader(std::span<const unsigned char> bytes) : m_bytes{bytes} {}
+
+    bool ok() const { return m_ok; }
+    bool at_end() const { return m_bytes.empty(); }
+
+    std::span<const unsigned char> bytes(std::size_t size) {
+        if (!m_ok || m_bytes.size() < size) {
+            m_ok = false;
+            return {};
+        }
+        const auto ret = m_bytes.first(size);
+        m_bytes = m_bytes.subspan(size);
+        return ret;
+    }
+    std::string_view chars(std::size_t size) {
+        const auto b = bytes(size);
+        return {reinterpret_cast<const char *>(b.data()), b.size()};
+    }
+    std::uint32_t u32() {
+        const auto b = bytes(4);
+        std::uint32_t value = 0;
+        for (std::size_t byte = 0; byte < b.size(); ++byte)
+            value |= std::uint32_t{b[byte]} << (8 * byte);
+        return value;
+    }
+    // Fills `out`, fails for values from `bound` on.
+    bool u32s(std::span<std::uint32_t> out, std::uint64_t bound) {
+        for (auto &value : out) {
+            value = u32();
+            if (value >= bound)
+                m_ok = false;
+        }
+        return m_ok;
+    }
+};
+
+} // namespace store_detail
+
+class group_store {
+    std::filesystem::path m_directory{};
+
+    explicit group_store(std::filesystem::path directory)
+        : m_directory{std::move(directory)} {}
+
+  public:
+    // Opens `directory`, and creates it, if needed.
+    [[nodiscard]] static std::optional<group_store>
+    open(const std::filesystem::path &directory) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec || !std::filesystem::is_directory(directory, ec))
+            return std::nullopt;
+        return group_store{directory};
+    }
+
+    const std::filesystem::path &directory() const { return m_directory; }
+
+    // The file of the group with `key`. Keys with the same hash share the
+    // file; the key in it tells them apart.
+    std::filesystem::path path_of(std::string_view key) const {
+        const auto hash = store_detail::fnv1a(std::span{
+            reinterpret_cast<const unsigned char *>(key.data()), key.size()});
+        return m_directory / std::format("{:016x}.group", hash);
+    }
+
+    // The group with `key`, or std::nullopt, if it is not stored, or if the
+    // file is damaged or belongs to another key.
+    [[nodiscard]] std::optional<stored_group>
+    load(std::string_view key) const {
+        std::FILE *file = std::fopen(path_of(key).string().c_str(), "rb");
+        if (!file)
+            return std::nullopt;
+        std::vector<unsigned char> bytes{};
+        unsigned char block[1 << 16];
+        while (const std::size_t n =
+                   std::fread(block, 1, sizeof block, file))
+            bytes.insert(bytes.end(), block, block + n);
+        const bool read_error = std::ferror(file) != 0;
+        std::fclose(file);
+        if (read_error || bytes.size() < 8zu)
+            return std::nullopt;
+
+        const auto content = std::span{bytes}.first(bytes.size() - 8zu);
+        store_detail::reader hash_reader(std::span{bytes}.last(8));
+        const std::uint64_t low = hash_reader.u32();
+        const std::uint64_t high = hash_reader.u32();
+        if (store_detail::fnv1a(content) != (low | (high << 32)))
+            return std::nullopt;
+
+        store_detail::reader in(content);
+        if (in.chars(sizeof store_detail::magic) !=
+                std::string_view{store_detail::magic,
+                                 sizeof store_detail::magic} ||
+            in.chars(in.u32()) != key || !in.ok())
+            return std::nullopt;
+
+        const std::uint32_t places = in.u32();
+        const std::uint32_t count = in.u32();
+        const std::uint32_t flags = in.u32();
+        // the sizes have to fit into the rest of the file
+        const std::uint64_t words = (content.size() + 3u) / 4u;
+        if (!in.ok() || places == 0u ||
+            std::uint64_t{places} * count > words ||
+            ((flags & store_detail::has_products) != 0u &&
+             std::uint64_t{count} * count > words))
+            return std::nullopt;
+
+        stored_group ret{.elements = permutation_arena(places, count)};
+        std::vector<char> seen(places);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            const auto perm = ret.elements.slot(i);
+            if (!in.u32s(perm, places))
+                return std::nullopt;
+            std::ranges::fill(seen, false);
+            for (const auto image : perm) {
+                if (seen[image])
+                    return std::nullopt;
+                seen[image] = true;
+            }
+            // The orders and the ids of the products refer to the order of
+            // the set, so the elements have to be in it, without duplicates.
+            if (i > 0u && !std::ranges::lexicographical_compare(
+                              ret.elements[i - 1u], perm))
+                return std::nullopt;
+        }
+        if ((flags & store_detail::has_orders) != 0u) {
+            ret.orders.resize(count);
+            if (!in.u32s(ret.orders, std::uint64_t{count} + 1u))
+                return std::nullopt;
+        }
+        if ((flags & store_detail::has_products) != 0u) {
+            ret.products.resize(std::size_t{count} * count);
+            if (!in.u32s(ret.products, count))
+                return std::nullopt;
+        }
+        if (!in.ok() || !in.at_end())
+            return std::nullopt;
+        return ret;
+    }
+
+    // Stores `group` as the group with `key`. Returns false, if it could not
+    // be written, then the store is as before.
+    [[nodiscard]] bool save(std::string_view key,
+                            const stored_group &group) const {
+        const std::size_t count = group.elements.size();
+        if (group.elements.places() == 0zu ||
+            (!group.orders.empty() && group.orders.size() != count) ||
+            (!group.products.empty() &&
+             group.products.size() != count * count))
+            return false;
+
+        std::vector<unsigned char> bytes(std::begin(store_detail::magic),
+                                         std::end(store_detail::magic));
+        bytes.reserve(key.size() +
+                      4zu * (8zu + group.elements.entries().size() +
+                             group.orders.size() + group.products.size()));
+        store_detail::append_u32(bytes, static_cast<std::uint32_t>(key.size()));
+        bytes.insert(bytes.end(), key.begin(), key.end());
+        store_detail::append_u32(
+            bytes, static_cast<std::uint32_t>(group.elements.places()));
+        store_detail::append_u32(bytes, static_cast<std::uint32_t>(count));
+        store_detail::append_u32(
+            bytes,
+            (group.orders.empty() ? 0u : store_detail::has_orders) |
+                (group.products.empty() ? 0u : store_detail::has_products));
+        for (const auto part : {group.elements.entries(),
+                                std::span<const std::uint32_t>{group.orders},
+                                std::span<const std::uint32_t>{
+                                    group.products}})
+            for (const auto value : part)
+                store_detail::append_u32(bytes, value);
+        const std::uint64_t hash = store_detail::fnv1a(bytes);
+        store_detail::append_u32(bytes, static_cast<std::uint32_t>(hash));
+        store_detail::append_u32(bytes,
+                                 static_cast<std::uint32_t>(hash >> 32));
+
+        const std::filesystem::path path = path_of(key);
+        std::filesystem::path temporary = path;
+        temporary += std::format(".{:08x}.tmp", std::random_device{}());
+        std::FILE *file = std::fopen(temporary.string().c_str(), "wb");
+        if (!file)
+            return false;
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) ==
+                  bytes.size();
+        ok = std::fclose(file) == 0 && ok;
+
+        std::error_code ec;
+        if (ok)
+            std::filesystem::rename(temporary, path, ec);
+        if (!ok || ec) {
+            std::filesystem::remove(temporary, ec);
+            return false;
+        }
+        return true;
+    }
+};
+
+} // namespace permutations
@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace permutations {
+
+// Composition and inversion of permutations of millions of points, e.g.
+// shuffles of data indices. A plain loop for a ∘ b or for the inverse reads
+// a[b[i]] or writes out[a[i]] at random, and for a permutation much larger
+// than the caches every one of those accesses is a cache miss. The kernels
+// here partition the accesses by their target first, with a counting sort by
+// the high bits, into buckets, whose targets are about as large as the L2
+// cache. Then they do the random accesses bucket by bucket, and at the end
+// they undo the partition. Every pass streams through memory, and all passes
+// are split among threads. That saves about a quarter of the time of the
+// plain loops on one core; it does not reach the memory bandwidth. Below
+// `blocked_permutation_threshold` points the plain loops are faster.
+
+// From this size on `compose_permutations`, `compose_permutations_into` and
+// `inverse` of permutations of any width use the kernels below. 2^23 entries
+// are 32 MB with 32 bit entries, more than most L3 caches.
+inline constexpr std::size_t blocked_permutation_threshold = 1zu << 23;
+
+namespace blocked_detail {
+
+// A partition pass writes to, or reads from, as many places at once as there
+// are buckets. With more than a few hundred of them the caches and the TLB
+// lose track, which costs more than buckets larger than the L2 cache. So
+// there are at most 2^8 buckets, of at least 2^16 entries; for 10^8 points
+// a bucket is 2^19 entries, 2 MB with 32 bit entries.
+inline constexpr int min_bucket_bits = 16;
+inline constexpr std::size_t max_buckets = 1zu << 8;
+
+template <typename F> void run_threads(std::size_t number_of_threads, F &&f) {
+    if (number_of_threads <= 1zu) {
+        f(0zu);
+        return;
+    }
+    std::vector<std::jthread> threads{};
+    threads.reserve(number_of_threads);
+    for (std::size_t t = 0; t < number_of_threads; ++t)
+        threads.emplace_back([&f, t] { f(t); });
+}
+
+// A partition of [0, size) by key >> shift. Thread t partitions the indices
+// [first(t), first(t + 1)); its part of a bucket starts at
+// offsets[t * buckets + bucket], the parts of a bucket are consecutive, and
+// so are the buckets.
+class partition {
+    std::size_t m_size{};
+    std::size_t m_threads{};
+    int m_shift{};
+    std::size_t m_buckets{};
+    std::vector<std::size_t> m_offsets{};
+
+  public:
+    partition(std::size_t size, std::size_t number_of_threads)
+        : m_size{size}, m_threads{std::clamp(number_of_threads, 1zu,
+                                             std::max(size, 1zu))} {
+        const std::size_t per_bucket =
+            (size + max_buckets - 1zu) / max_buckets;
+        m_shift =
+            std::max(min_bucket_bits,
+                     static_cast<int>(std::bit_width(per_bucket - 1zu)));
+        m_buckets = size == 0zu ? 0zu : ((size - 1zu) >> m_shift) + 1zu;
+        m_offsets.assign(m_threads * m_buckets, 0zu);
+    }
+
+    std::size_t first(std::size_t t) const { return m_size * t / m_threads; }
+    std::size_t bucket_begin(std::size_t bucket) const {
+        return bucket == m_buckets ? m_size : m_offsets[bucket];
+    }
+
+    // Counts the keys of every thread, `key(i)` for the indices i of the
+    // thread, and sets the offsets. Returns false, if a key is not below
+    // the size.
+    template <typename Key> [[nodiscard]] bool count(Key &&key) {
+        std::vector<char> ok(m_threads, true);
+        run_threads(m_threads, [&](std::size_t t) {
+            const auto counts =
+                std::span{m_offsets}.subspan(t * m_buckets, m_buckets);
+            const std::size_t size = m_size;
+            const int shift = m_shift;
+            const std::size_t last = first(t + 1zu);
+            for (std::size_t i = first(t); i < last; ++i) {
+                const std::size_t k = key(i);
+                if (k >= size) {
+                    ok[t] = false;
+                    return;
+                }
+                ++counts[k >> shift];
+            }
+        });
+        if (!std::ranges::all_of(ok, [](char b) { return b != 0; }))
+            return false;
+        std::size_t position = 0;
+        for (std::size_t bucket = 0; bucket < m_buckets; ++bucket) {
+            for (std::size_t t = 0; t < m_threads; ++t) {
+                const std::size_t count = m_offsets[t * m_buckets + bucket];
+                m_offsets[t * m_buckets + bucket] = position;
+                position += count;
+            }
+        }
+        return true;
+    }
+
+    // Runs `f(i, position)` for every index i, with the next position in
+    // the part of the thread of i of the bucket of `key(i)`. Every thread
+    // goes through its indices in order, so a second run gives the same
+    // positions.
+    template <typename Key, typename F>
+    void for_each_index(const Key &key, F &&f) const {
+        run_threads(m_threads, [&](std::size_t t) {
+            const auto row =
+                std::span{m_offsets}.subspan(t * m_buckets, m_buckets);
+            std::vector<std::size_t> cursors(row.begin(), row.end());
+            const int shift = m_shift;
+            const std::size_t last = first(t + 1zu);
+            for (std::size_t i = first(t); i < last; ++i)
+                f(i, cursors[key(i) >> shift]++);
+        });
+    }
+
+    // Runs `f(bucket)` for every bucket, the buckets split among the threads.
+    template <typename F> void for_each_bucket(F &&f) const {
+        run_threads(m_threads, [&](std::size_t t) {
+            for (std::size_t bucket = m_buckets * t / m_threads;
+                 bucket < m_buckets * (t + 1zu) / m_threads; ++bucket)
+                f(bucket);
+        });
+    }
+};
+
+} // namespace blocked_detail
+
+// out[i] = a[b[i]], i.e. a ∘ b, like `compose_permutations_into`. `out` must
+// not overlap with `a` or `b`. Returns false, if an entry of `b` is out of
+// range; then `out` is unchanged.
+template <std::unsigned_integral Out, std::unsigned_integral A,
+          std::unsigned_integral B>
+[[nodiscard]] bool blocked_compose_into(
+    std::span<Out> out, std::span<const A> a, std::span<const B> b,
+    std::size_t number_of_threads = std::thread::hardware_concurrency()) {
+    const std::size_t size = out.size();
+    if (a.size() != size || b.size() != size ||
+        size - 1zu > std::numeric_limits<std::uint32_t>::max())
+        return size == 0zu && a.empty() && b.empty();
+    const auto key = [b](std::size_t i) { return std::size_t{b[i]}; };
+    blocked_detail::partition parts(size, number_of_threads);
+    if (!parts.count(key))
+        return false;
+
+    // b[i] partitioned by its bucket, then replaced by a[b[i]]
+    const auto scratch =
+        std::make_unique_for_overwrite<std::uint32_t[]>(size);
+    parts.for_each_index(key, [&](std::size_t i, std::size_t position) {
+        scratch[position] = static_cast<std::uint32_t>(b[i]);
+    });
+    parts.for_each_bucket([&](std::size_t bucket) {
+        const std::size_t last = parts.bucket_begin(bucket + 1zu);
+        for (std::size_t j = parts.bucket_begin(bucket); j < last; ++j)
+            scratch[j] = static_cast<std::uint32_t>(a[scratch[j]]);
+    });
+    parts.for_each_index(key, [&](std::size_t i, std::size_t position) {
+        out[i] = static_cast<Out>(scratch[position]);
+    });
+    return true;
+}
+
+// out[a[i]] = i, the inverse of `a`, like `inverse`. `out` must not
+// overlap with `a`. Returns false, if an entry of `a` is out of range; then
+// `out` is unchanged. If `a` has an entry twice, `out` is no permutation.
+template <std::unsigned_integral Out, std::unsigned_integral A>
+[[nodiscard]] bool blocked_inverse_into(
+    std::span<Out> out, std::span<const A> a,
+    std::size_t number_of_threads = std::thread::hardware_concurrency()) {
+    const std::size_t size = out.size();
+    if (a.size() != size ||
+        size - 1zu > std::numeric_limits<std::uint32_t>::max())
+        return size == 0zu && a.empty();
+    const auto key = [a](std::size_t i) { return std::size_t{a[i]}; };
+    blocked_detail::partition parts(size, number_of_threads);
+    if (!parts.count(key))
+        return false;
+
+    // the pairs (a[i], i) partitioned by the bucket of a[i]
+    const auto scratch =
+        std::make_unique_for_overwrite<std::uint64_t[]>(size);
+    parts.for_each_index(key, [&](std::size_t i, std::size_t position) {
+        scratch[position] = (std::uint64_t{a[i]} << 32) | i;
+    });
+    parts.for_each_bucket([&](std::size_t bucket) {
+        const std::size_t last = parts.bucket_begin(bucket + 1zu);
+        for (std::size_t j = parts.bucket_begin(bucket); j < last; ++j)
+            out[scratch[j] >> 32] = static_cast<Out>(scratch[j]);
+    });
+    return true;
+}
+
+} // namespace permutations
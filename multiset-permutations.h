@@ -0,0 +1,483 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace permutations {
+
+// Permutations of a multiset ("words"): symbol `s` occurs exactly `counts[s]`
+// times in every word. With two symbols these are the
+// n-choose-k combinations.
+//
+// The words are generated in cool-lex order, see
+// Aaron Williams, "Loopless Generation of Multiset Permutations using a
+// Constant Number of Variables by Prefix Shifts", SODA 2009.
+// Every successor is obtained by taking one symbol and moving it to the front
+// of the word, which rotates a prefix of the word by one place. These prefixes
+// are only a few symbols long on average, so a walk over all words costs
+// amortised O(1) per word.
+class multiset_permutation_engine {
+  public:
+    typedef std::uint8_t symbol_t;
+    typedef std::span<const symbol_t> readonly_span;
+    static constexpr std::size_t max_number_of_symbols = 256zu;
+
+  private:
+    std::vector<symbol_t> m_word{};
+    // position of the node called `i` in the paper; `j` is always `i + 1`
+    std::size_t m_i{};
+    // length of the prefix that was rotated by the last call to `next()`
+    std::size_t m_changed_prefix{};
+
+  public:
+    multiset_permutation_engine() = default;
+    explicit multiset_permutation_engine(
+        std::span<const std::uint32_t> counts) {
+        assert(std::cmp_less_equal(counts.size(), max_number_of_symbols));
+        std::size_t size = 0;
+        for (auto c : counts)
+            size += c;
+        m_word.reserve(size);
+
+        // The first word is sorted in non-increasing order.
+        for (std::size_t s = counts.size(); s-- > 0zu;)
+            m_word.insert(m_word.end(), counts[s], static_cast<symbol_t>(s));
+        m_i = size >= 2zu ? size - 2zu : 0zu;
+        m_changed_prefix = size;
+    }
+
+    constexpr readonly_span current() const { return m_word; }
+    constexpr std::size_t size() const { return m_word.size(); }
+
+    // Number of symbols at the front of `current()`, that changed with the
+    // last step. After construction it is the whole word.
+    constexpr std::size_t changed_prefix() const { return m_changed_prefix; }
+
+    // Advance to the next word. Returns false, if the current word is the
+    // last one. The word is left unchanged in that case.
+    bool next() {
+        auto &a = m_word;
+        const std::size_t n = a.size();
+        if (n < 2zu)
+            return false;
+
+        const std::size_t j = m_i + 1zu;
+        const bool j_has_next = j + 1zu < n;
+        if (!j_has_next && a[j] >= a[0])
+            return false;
+
+        const std::size_t s = (j_has_next && a[m_i] >= a[j + 1zu]) ? j : m_i;
+        const std::size_t t = s + 1zu;
+        const symbol_t moved = a[t];
+        std::shift_right(a.begin(), a.begin() + t + 1zu, 1);
+        a[0] = moved;
+
+        m_i = (moved < a[1]) ? 0zu : m_i + 1zu;
+        m_changed_prefix = t + 1zu;
+        return true;
+    }
+};
+
+typedef unsigned __int128 multiset_rank_t;
+
+// `a = a * b / d` for a product that is known to be divisible by `d`.
+// Returns false, if the result does not fit into `Count`.
+template <typename Count>
+[[nodiscard]] constexpr bool mul_div_exact(Count &a, std::uint64_t b,
+                                           std::uint64_t d) {
+    const std::uint64_t g = std::gcd(b, d);
+    b /= g;
+    d /= g;
+    assert(a % d == 0u);
+    return !__builtin_mul_overflow(a / d, b, &a);
+}
+
+// Counting-only mode: the multinomial coefficient
+// (c0 + c1 + ... )! / (c0! * c1! * ...).
+// Returns std::nullopt, if the result does not fit into `Count`. Use
+// `multiset_rank_t` as `Count` for 128 bit counts.
+template <typename Count = std::uint64_t>
+    requires std::same_as<Count, std::uint64_t> ||
+             std::same_as<Count, multiset_rank_t>
+[[nodiscard]] std::optional<Count>
+count_multiset_permutations(std::span<const std::uint32_t> counts) {
+    Count result = 1;
+    std::uint64_t length = 0;
+    for (const std::uint32_t c : counts) {
+        // Adding one more copy of a symbol, that already occurs `r` times, to
+        // words of length `length` multiplies the count by (length+1)/(r+1).
+        for (std::uint64_t r = 0; r < c; ++r) {
+            ++length;
+            if (!mul_div_exact(result, length, r + 1u))
+                return std::nullopt;
+        }
+    }
+    return result;
+}
+
+// Callback mode: `call_back` is invoked with every word as span of symbol
+// indices. If it returns bool, `false` stops the walk and makes this function
+// return `false`.
+template <typename CallBack>
+    requires std::invocable<CallBack &,
+                            multiset_permutation_engine::readonly_span>
+[[nodiscard]] bool
+for_each_multiset_permutation(std::span<const std::uint32_t> counts,
+                              CallBack &&call_back) {
+    using return_t =
+        std::invoke_result_t<CallBack &,
+                             multiset_permutation_engine::readonly_span>;
+    static_assert(std::same_as<return_t, bool> || std::same_as<return_t, void>);
+
+    if (std::cmp_greater(counts.size(),
+                         multiset_permutation_engine::max_number_of_symbols))
+        return false;
+
+    multiset_permutation_engine engine(counts);
+    do {
+        if constexpr (std::is_same_v<return_t, void>) {
+            call_back(engine.current());
+        } else if (!call_back(engine.current())) {
+            return false;
+        }
+    } while (engine.next());
+    return true;
+}
+
+// Assembles rows `prefix`, word, `suffix` in a large buffer and hands them to
+// `std::fwrite` in big blocks, so stdio is not involved per row. Symbol `s` is
+// printed as `symbols[s]`. Only the part of the word that changed since the
+// previous row has to be rendered again.
+class multiset_row_writer {
+    std::FILE *m_stream{};
+    std::string_view m_symbols{};
+    std::string m_row{};
+    std::size_t m_word_offset{};
+    std::vector<char> m_buffer{};
+    std::size_t m_used{};
+    bool m_error{};
+
+    // Hands the buffered rows to the stream, without flushing it.
+    bool write_buffer() {
+        if (m_error)
+            return false;
+        if (std::fwrite(m_buffer.data(), 1, m_used, m_stream) != m_used)
+            m_error = true;
+        m_used = 0;
+        return !m_error;
+    }
+
+  public:
+    static constexpr std::size_t buffer_size = 1zu << 20;
+
+    multiset_row_writer(std::FILE *stream, std::string_view symbols,
+                        std::size_t word_size, std::string_view prefix = "|",
+                        std::string_view suffix = "|\n")
+        : m_stream{stream}, m_symbols{symbols}, m_word_offset{prefix.size()} {
+        m_row.reserve(prefix.size() + word_size + suffix.size());
+        m_row += prefix;
+        m_row.append(word_size, '\0');
+        m_row += suffix;
+        m_buffer.resize(std::max(buffer_size, m_row.size()));
+    }
+
+    // Renders the positions [first, last) of `word` and appends the row.
+    bool write(multiset_permutation_engine::readonly_span word,
+               std::size_t first, std::size_t last) {
+        assert(std::cmp_less_equal(last, word.size()));
+        char *const row_word = m_row.data() + m_word_offset;
+        for (std::size_t i = first; i < last; ++i) {
+            assert(std::cmp_less(word[i], m_symbols.size()));
+            row_word[i] = m_symbols[word[i]];
+        }
+
+        if (m_buffer.size() - m_used < m_row.size() && !write_buffer())
+            return false;
+        std::memcpy(m_buffer.data() + m_used, m_row.data(), m_row.size());
+        m_used += m_row.size();
+        return true;
+    }
+
+    // Writes the buffered rows and flushes the stream; once at the end.
+    bool flush() {
+        if (!write_buffer())
+            return false;
+        if (std::fflush(m_stream) != 0)
+            m_error = true;
+        return !m_error;
+    }
+
+    // Writes the rows left, if `flush` was not called after the last one.
+    ~multiset_row_writer() {
+        if (m_used != 0zu)
+            flush();
+    }
+};
+
+// Bulk text mode: writes every word as one row to `stream`, see
+// `multiset_row_writer`.
+[[nodiscard]] inline bool
+write_multiset_permutations(std::FILE *stream,
+                            std::span<const std::uint32_t> counts,
+                            std::string_view symbols,
+                            std::string_view prefix = "|",
+                            std::string_view suffix = "|\n") {
+    if (symbols.size() != counts.size() ||
+        std::cmp_greater(counts.size(),
+                         multiset_permutation_engine::max_number_of_symbols))
+        return false;
+
+    multiset_permutation_engine engine(counts);
+    multiset_row_writer writer(stream, symbols, engine.size(), prefix, suffix);
+    do {
+        if (!writer.write(engine.current(), 0zu, engine.changed_prefix()))
+            return false;
+    } while (engine.next());
+    return writer.flush();
+}
+
+// Ranking and unranking
+// ---------------------
+// Ranks refer to the lexicographic order of the words, where the symbols are
+// ordered by their index. This is not the order of
+// `multiset_permutation_engine`. Binary words (combinations) are the special
+// case of two symbols. All counts are 128 bit wide and checked for overflow,
+// so jobs like C(40,20) or 30-letter words over several symbols can be split
+// into rank ranges, e.g. with `multiset_rank_chunk`, and each worker starts
+// in the middle of the sequence with `for_each_multiset_permutation_in_ranks`.
+
+// Lexicographic rank of `word` among all words with the same symbol counts.
+// Returns std::nullopt, if a symbol is not less than `number_of_symbols` or
+// the number of words does not fit into 128 bits.
+[[nodiscard]] inline std::optional<multiset_rank_t>
+rank_multiset_permutation(multiset_permutation_engine::readonly_span word,
+                          std::size_t number_of_symbols) {
+    if (std::cmp_greater(number_of_symbols,
+                         multiset_permutation_engine::max_number_of_symbols))
+        return std::nullopt;
+    std::vector<std::uint32_t> counts(number_of_symbols, 0u);
+    for (auto s : word) {
+        if (std::cmp_greater_equal(s, number_of_symbols))
+            return std::nullopt;
+        counts[s] += 1u;
+    }
+
+    auto remaining_opt = count_multiset_permutations<multiset_rank_t>(counts);
+    if (!remaining_opt)
+        return std::nullopt;
+    // number of words, that can be built from the not yet consumed symbols
+    multiset_rank_t remaining = *remaining_opt;
+    multiset_rank_t rank = 0;
+    std::uint64_t length = word.size();
+    for (auto symbol : word) {
+        // Words, that have a smaller symbol at this position, come first.
+        for (std::size_t s = 0; s < symbol; ++s) {
+            if (counts[s] == 0u)
+                continue;
+            multiset_rank_t words_with_s = remaining;
+            // cannot overflow, because the result is at most `remaining`
+            (void)mul_div_exact(words_with_s, counts[s], length);
+            rank += words_with_s;
+        }
+        (void)mul_div_exact(remaining, counts[symbol], length);
+        counts[symbol] -= 1u;
+        length -= 1u;
+    }
+    return rank;
+}
+
+// Writes the word with lexicographic rank `rank` into `word`.
+// Returns false, if `rank` is out of range or `word` has the wrong size.
+[[nodiscard]] inline bool unrank_multiset_permutation(
+    std::span<const std::uint32_t> counts, multiset_rank_t rank,
+    std::span<multiset_permutation_engine::symbol_t> word) {
+    if (std::cmp_greater(counts.size(),
+                         multiset_permutation_engine::max_number_of_symbols))
+        return false;
+    auto remaining_opt = count_multiset_permutations<multiset_rank_t>(counts);
+    if (!remaining_opt || rank >= *remaining_opt)
+        return false;
+    multiset_rank_t remaining = *remaining_opt;
+
+    std::vector<std::uint32_t> left(counts.begin(), counts.end());
+    std::uint64_t length = 0;
+    for (auto c : counts)
+        length += c;
+    if (length != word.size())
+        return false;
+
+    for (auto &out : word) {
+        for (std::size_t s = 0; s < left.size(); ++s) {
+            if (left[s] == 0u)
+                continue;
+            multiset_rank_t words_with_s = remaining;
+            (void)mul_div_exact(words_with_s, left[s], length);
+            if (rank < words_with_s) {
+                out = static_cast<multiset_permutation_engine::symbol_t>(s);
+                remaining = words_with_s;
+                left[s] -= 1u;
+                break;
+            }
+            rank -= words_with_s;
+        }
+        length -= 1u;
+    }
+    return true;
+}
+
+// Lexicographic successor of `word` (like `std::next_permutation`).
+// Returns the first position that changed, or std::nullopt, if `word` is the
+// last word.
+[[nodiscard]] inline std::optional<std::size_t>
+next_lexicographic_multiset_permutation(
+    std::span<multiset_permutation_engine::symbol_t> word) {
+    const std::size_t n = word.size();
+    if (n < 2zu)
+        return std::nullopt;
+    std::size_t i = n - 1zu;
+    while (i > 0zu && word[i - 1zu] >= word[i])
+        --i;
+    if (i == 0zu)
+        return std::nullopt;
+    std::size_t j = n - 1zu;
+    while (word[j] <= word[i - 1zu])
+        --j;
+    std::swap(word[i - 1zu], word[j]);
+    std::reverse(word.begin() + i, word.end());
+    return i - 1zu;
+}
+
+// The ranks [lo, hi) of chunk `index` when [0, total) is split into `chunks`
+// chunks, whose sizes differ by at most one.
+constexpr std::pair<multiset_rank_t, multiset_rank_t>
+multiset_rank_chunk(multiset_rank_t total, std::size_t index,
+                    std::size_t chunks) {
+    assert(index < chunks);
+    const multiset_rank_t quotient = total / chunks;
+    const multiset_rank_t remainder = total % chunks;
+    auto start = [&](multiset_rank_t i) {
+        return quotient * i + std::min(i, remainder);
+    };
+    return {start(index), start(index + 1zu)};
+}
+
+// Like `for_each_multiset_permutation`, but only for the words with the
+// lexicographic ranks [lo, hi). `hi` is clamped to the number of words.
+template <typename CallBack>
+    requires std::invocable<CallBack &,
+                            multiset_permutation_engine::readonly_span>
+[[nodiscard]] bool
+for_each_multiset_permutation_in_ranks(std::span<const std::uint32_t> counts,
+                                       multiset_rank_t lo, multiset_rank_t hi,
+                                       CallBack &&call_back) {
+    using return_t =
+        std::invoke_result_t<CallBack &,
+                             multiset_permutation_engine::readonly_span>;
+    static_assert(std::same_as<return_t, bool> || std::same_as<return_t, void>);
+
+    auto total = count_multiset_permutations<multiset_rank_t>(counts);
+    if (!total)
+        return false;
+    hi = std::min(hi, *total);
+    if (lo >= hi)
+        return true;
+
+    std::uint64_t length = 0;
+    for (auto c : counts)
+        length += c;
+    std::vector<multiset_permutation_engine::symbol_t> word(length);
+    if (!unrank_multiset_permutation(counts, lo, word))
+        return false;
+
+    for (multiset_rank_t rank = lo; rank < hi; ++rank) {
+        if (rank != lo)
+            (void)next_lexicographic_multiset_permutation(word);
+        if constexpr (std::is_same_v<return_t, void>) {
+            call_back(multiset_permutation_engine::readonly_span{word});
+        } else if (!call_back(
+                       multiset_permutation_engine::readonly_span{word})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Bulk text mode for the words with the lexicographic ranks [lo, hi).
+[[nodiscard]] inline bool write_multiset_permutations_in_ranks(
+    std::FILE *stream, std::span<const std::uint32_t> counts,
+    multiset_rank_t lo, multiset_rank_t hi, std::string_view symbols,
+    std::string_view prefix = "|", std::string_view suffix = "|\n") {
+    if (symbols.size() != counts.size())
+        return false;
+    auto total = count_multiset_permutations<multiset_rank_t>(counts);
+    if (!total)
+        return false;
+    hi = std::min(hi, *total);
+    if (lo >= hi)
+        return true;
+
+    std::uint64_t length = 0;
+    for (auto c : counts)
+        length += c;
+    std::vector<multiset_permutation_engine::symbol_t> word(length);
+    if (!unrank_multiset_permutation(counts, lo, word))
+        return false;
+
+    multiset_row_writer writer(stream, symbols, word.size(), prefix, suffix);
+    std::size_t first_changed = 0;
+    for (multiset_rank_t rank = lo; rank < hi; ++rank) {
+        if (rank != lo)
+            first_changed = *next_lexicographic_multiset_permutation(word);
+        if (!writer.write(word, first_changed, word.size()))
+            return false;
+    }
+    return writer.flush();
+}
+
+// Splits all words into `number_of_threads` rank ranges and walks them
+// concurrently. `call_back(thread_index, word)` must be safe to call from
+// several threads at once.
+template <typename CallBack>
+    requires std::invocable<CallBack &, std::size_t,
+                            multiset_permutation_engine::readonly_span>
+[[nodiscard]] bool
+for_each_multiset_permutation_parallel(std::span<const std::uint32_t> counts,
+                                       std::size_t number_of_threads,
+                                       CallBack &&call_back) {
+    auto total = count_multiset_permutations<multiset_rank_t>(counts);
+    if (!total || number_of_threads == 0zu)
+        return false;
+
+    std::vector<char> results(number_of_threads, false);
+    {
+        std::vector<std::jthread> threads{};
+        threads.reserve(number_of_threads);
+        for (std::size_t t = 0; t < number_of_threads; ++t) {
+            threads.emplace_back([&, t] {
+                auto [lo, hi] =
+                    multiset_rank_chunk(*total, t, number_of_threads);
+                results[t] = for_each_multiset_permutation_in_ranks(
+                    counts, lo, hi,
+                    [&](multiset_permutation_engine::readonly_span word) {
+                        return call_back(t, word);
+                    });
+            });
+        }
+    }
+    return std::ranges::all_of(results, [](char r) { return r != 0; });
+}
+
+} // namespace permutations
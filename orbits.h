@@ -0,0 +1,367 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "permutation-arena.h"
+
+namespace permutations {
+
+// How the group generated by some permutations acts on points, pairs and
+// k-subsets, computed from the generators alone, without the elements of the
+// group. The objects of an action are numbered by ranks 0 .. size() - 1, and
+// a domain maps a rank to the rank of its image under one generator. As
+// everywhere, a permutation is an array of images: perm[i] is the image of i.
+
+// The points 0 .. places - 1 themselves.
+class point_domain {
+    std::uint32_t m_places{};
+
+  public:
+    explicit point_domain(std::uint32_t places) : m_places{places} {}
+
+    std::uint32_t places() const { return m_places; }
+    std::uint64_t size() const { return m_places; }
+    std::uint32_t image(std::span<const std::uint32_t> perm,
+                        std::uint64_t rank) const {
+        return perm[rank];
+    }
+};
+
+// The k-element subsets of the points, ranked in colexicographic order: the
+// subset c_0 < c_1 < ... < c_{k-1} has the rank sum_i C(c_i, i + 1). For
+// k = 2 these are the unordered pairs.
+class k_subset_domain {
+    std::uint32_t m_places{};
+    std::uint32_t m_k{};
+    std::uint64_t m_size{};
+    // C(c, i) at c * (k + 1) + i
+    std::vector<std::uint64_t> m_binomials{};
+
+    k_subset_domain() = default;
+
+    std::uint64_t binomial(std::uint32_t c, std::uint32_t i) const {
+        return m_binomials[std::size_t{c} * (m_k + 1u) + i];
+    }
+
+  public:
+    // Returns std::nullopt, if k > places, or if there are 2^32 subsets or
+    // more, which would not fit into the 32 bit ranks of the results.
+    [[nodiscard]] static std::optional<k_subset_domain>
+    create(std::uint32_t places, std::uint32_t k) {
+        if (k > places)
+            return std::nullopt;
+        k_subset_domain ret{};
+        ret.m_places = places;
+        ret.m_k = k;
+        ret.m_binomials.resize((std::size_t{places} + 1zu) * (k + 1u));
+        constexpr std::uint64_t limit =
+            std::numeric_limits<std::uint32_t>::max();
+        for (std::uint32_t c = 0; c <= places; ++c) {
+            ret.m_binomials[std::size_t{c} * (k + 1u)] = 1u;
+            for (std::uint32_t i = 1; i <= k && i <= c; ++i) {
+                // saturated, only the values up to C(places, k) matter
+                const std::uint64_t value =
+                    ret.binomial(c - 1u, i - 1u) +
+                    (i <= c - 1u ? ret.binomial(c - 1u, i) : 0u);
+                ret.m_binomials[std::size_t{c} * (k + 1u) + i] =
+                    std::min(value, limit);
+            }
+        }
+        ret.m_size = ret.binomial(places, k);
+        if (ret.m_size >= limit)
+            return std::nullopt;
+        return ret;
+    }
+
+    std::uint32_t places() const { return m_places; }
+    std::uint32_t k() const { return m_k; }
+    std::uint64_t size() const { return m_size; }
+
+    // `subset` sorted ascending
+    std::uint64_t rank(std::span<const std::uint32_t> subset) const {
+        assert(subset.size() == m_k);
+        std::uint64_t ret = 0;
+        for (std::uint32_t i = 0; i < m_k; ++i)
+            ret += binomial(subset[i], i + 1u);
+        return ret;
+    }
+    // Writes the subset of `rank` ascending into `subset`.
+    void unrank(std::uint64_t rank, std::span<std::uint32_t> subset) const {
+        assert(subset.size() == m_k && rank < m_size);
+        std::uint32_t bound = m_places;
+        for (std::uint32_t i = m_k; i-- > 0u;) {
+            // binary search for the largest c < bound with
+            // C(c, i + 1) <= rank, which is at least c = i
+            std::uint32_t low = i;
+            std::uint32_t high = bound;
+            while (high - low > 1u) {
+                const std::uint32_t middle = low + (high - low) / 2u;
+                if (binomial(middle, i + 1u) <= rank)
+                    low = middle;
+                else
+                    high = middle;
+            }
+            subset[i] = low;
+            rank -= binomial(low, i + 1u);
+            bound = low;
+        }
+    }
+    std::uint32_t image(std::span<const std::uint32_t> perm,
+                        std::uint64_t rank) const {
+        // k is small, so the subset lives on the stack for k <= 16
+        std::uint32_t small[16];
+        std::vector<std::uint32_t> large{};
+        std::span<std::uint32_t> subset{small, std::min(m_k, 16u)};
+        if (m_k > 16u) {
+            large.resize(m_k);
+            subset = large;
+        }
+        unrank(rank, subset);
+        for (auto &point : subset)
+            point = perm[point];
+        std::ranges::sort(subset);
+        return static_cast<std::uint32_t>(this->rank(subset));
+    }
+};
+
+// The orbits of all objects of a domain, see `orbits_of`.
+struct orbit_decomposition {
+    // the index of the orbit of every rank
+    std::vector<std::uint32_t> orbit_of{};
+    // the ranks of every orbit, ascending; the orbits are ordered by their
+    // smallest rank
+    std::vector<std::vector<std::uint32_t>> orbits{};
+};
+
+// The orbit of one object, with the Schreier vector, that tells for every
+// object of the orbit, by which generator it was reached from which object,
+// see `schreier_tree_of`.
+struct schreier_tree {
+    static constexpr std::uint32_t not_in_orbit =
+        std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t root{};
+    // the orbit in breadth-first order, `root` first
+    std::vector<std::uint32_t> orbit{};
+    // the generator, that maps `parent[x]` to x, or `not_in_orbit`; for the
+    // root it is the number of generators
+    std::vector<std::uint32_t> generator{};
+    std::vector<std::uint32_t> parent{};
+
+    bool contains(std::uint32_t rank) const {
+        return generator[rank] != not_in_orbit;
+    }
+
+    // The indices of generators g_1, ..., g_m with g_m(... g_1(root)) =
+    // `rank`; a shortest such word, because the tree is breadth-first. Empty
+    // for the root, std::nullopt, if `rank` is not in the orbit.
+    std::optional<std::vector<std::uint32_t>>
+    transversal_word(std::uint32_t rank) const {
+        if (!contains(rank))
+            return std::nullopt;
+        std::vector<std::uint32_t> word{};
+        for (; rank != root; rank = parent[rank])
+            word.push_back(generator[rank]);
+        std::ranges::reverse(word);
+        return word;
+    }
+};
+
+namespace orbit_detail {
+
+inline bool are_permutations(const permutation_arena &generators) {
+    std::vector<char> seen(generators.places());
+    for (std::size_t g = 0; g < generators.size(); ++g) {
+        std::ranges::fill(seen, false);
+        for (const auto image : generators[g]) {
+            if (image >= seen.size() || seen[image])
+                return false;
+            seen[image] = true;
+        }
+    }
+    return true;
+}
+
+// union-find with path halving and union by size
+class disjoint_sets {
+    std::vector<std::uint32_t> m_parent{};
+    std::vector<std::uint32_t> m_size{};
+
+  public:
+    explicit disjoint_sets(std::size_t count)
+        : m_parent(count), m_size(count, 1u) {
+        std::iota(m_parent.begin(), m_parent.end(), 0u);
+    }
+
+    std::uint32_t find(std::uint32_t x) {
+        while (m_parent[x] != x) {
+            m_parent[x] = m_parent[m_parent[x]];
+            x = m_parent[x];
+        }
+        return x;
+    }
+    void unite(std::uint32_t a, std::uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return;
+        if (m_size[a] < m_size[b])
+            std::swap(a, b);
+        m_parent[b] = a;
+        m_size[a] += m_size[b];
+    }
+};
+
+} // namespace orbit_detail
+
+// The orbits of the group generated by `generators` on `domain`, with one
+// union of x and g(x) for every object x and generator g. Returns
+// std::nullopt, if a generator is no permutation of `domain.places()`
+// points.
+template <typename Domain>
+[[nodiscard]] std::optional<orbit_decomposition>
+orbits_of(const Domain &domain, const permutation_arena &generators) {
+    if (generators.places() != domain.places() ||
+        !orbit_detail::are_permutations(generators))
+        return std::nullopt;
+    const auto size = static_cast<std::uint32_t>(domain.size());
+    orbit_detail::disjoint_sets sets(size);
+    for (std::size_t g = 0; g < generators.size(); ++g)
+        for (std::uint32_t x = 0; x < size; ++x)
+            sets.unite(x, domain.image(generators[g], x));
+
+    orbit_decomposition ret{};
+    ret.orbit_of.resize(size);
+    // the representative of a set to the index of its orbit
+    std::vector<std::uint32_t> index(size, schreier_tree::not_in_orbit);
+    for (std::uint32_t x = 0; x < size; ++x) {
+        auto &orbit = index[sets.find(x)];
+        if (orbit == schreier_tree::not_in_orbit) {
+            orbit = static_cast<std::uint32_t>(ret.orbits.size());
+            ret.orbits.emplace_back();
+        }
+        ret.orbit_of[x] = orbit;
+        ret.orbits[orbit].push_back(x);
+    }
+    return ret;
+}
+
+// The orbit of `root` by breadth-first search, with its Schreier vector.
+// Returns std::nullopt for invalid generators, see `orbits_of`, or a `root`
+// outside of `domain`.
+template <typename Domain>
+[[nodiscard]] std::optional<schreier_tree>
+schreier_tree_of(const Domain &domain, const permutation_arena &generators,
+                 std::uint32_t root) {
+    if (generators.places() != domain.places() || root >= domain.size() ||
+        !orbit_detail::are_permutations(generators))
+        return std::nullopt;
+    const auto size = static_cast<std::size_t>(domain.size());
+    schreier_tree ret{.root = root};
+    ret.generator.assign(size, schreier_tree::not_in_orbit);
+    ret.parent.assign(size, schreier_tree::not_in_orbit);
+    ret.generator[root] = static_cast<std::uint32_t>(generators.size());
+    ret.parent[root] = root;
+    ret.orbit.push_back(root);
+    for (std::size_t next = 0; next < ret.orbit.size(); ++next) {
+        const std::uint32_t x = ret.orbit[next];
+        for (std::size_t g = 0; g < generators.size(); ++g) {
+            const std::uint32_t y = domain.image(generators[g], x);
+            if (ret.contains(y))
+                continue;
+            ret.generator[y] = static_cast<std::uint32_t>(g);
+            ret.parent[y] = x;
+            ret.orbit.push_back(y);
+        }
+    }
+    return ret;
+}
+
+// The permutation of the points, that the transversal word of `rank` stands
+// for, i.e. an element of the group, that maps the root to `rank`.
+[[nodiscard]] inline std::optional<std::vector<std::uint32_t>>
+transversal_element(const schreier_tree &tree,
+                    const permutation_arena &generators, std::uint32_t rank) {
+    const auto word = tree.transversal_word(rank);
+    if (!word)
+        return std::nullopt;
+    std::vector<std::uint32_t> element(generators.places());
+    std::iota(element.begin(), element.end(), 0u);
+    std::vector<std::uint32_t> product(generators.places());
+    // g ∘ element for the letters in turn
+    for (const auto g : *word) {
+        const auto perm = generators[g];
+        for (std::size_t i = 0; i < element.size(); ++i)
+            product[i] = perm[element[i]];
+        element.swap(product);
+    }
+    return element;
+}
+
+// Generators of the stabilizer of the root of `tree` by Schreier's lemma: the
+// elements u_{g(x)}^-1 ∘ g ∘ u_x for every x of the orbit and generator g,
+// where u_x is the transversal element of x. The identity and duplicates are
+// left out. There are up to |orbit| × |generators| of them, so this is meant
+// for the orbits of small domains.
+template <typename Domain>
+[[nodiscard]] permutation_arena
+stabilizer_generators(const Domain &domain, const schreier_tree &tree,
+                      const permutation_arena &generators) {
+    const std::size_t places = generators.places();
+    // the transversal elements in the order of the orbit, each from the one
+    // of its parent with one multiplication
+    std::vector<std::uint32_t> position(tree.generator.size());
+    permutation_arena transversal(places, tree.orbit.size());
+    for (std::size_t i = 0; i < tree.orbit.size(); ++i) {
+        const std::uint32_t x = tree.orbit[i];
+        position[x] = static_cast<std::uint32_t>(i);
+        auto u = transversal.slot(i);
+        if (x == tree.root) {
+            std::iota(u.begin(), u.end(), 0u);
+            continue;
+        }
+        const auto parent = transversal[position[tree.parent[x]]];
+        const auto g = generators[tree.generator[x]];
+        for (std::size_t p = 0; p < places; ++p)
+            u[p] = g[parent[p]];
+    }
+
+    std::vector<std::vector<std::uint32_t>> found{};
+    std::vector<std::uint32_t> inverse(places);
+    std::vector<std::uint32_t> h(places);
+    for (std::size_t i = 0; i < tree.orbit.size(); ++i) {
+        const auto u_x = transversal[i];
+        for (std::size_t g = 0; g < generators.size(); ++g) {
+            const auto s = generators[g];
+            const std::uint32_t y = domain.image(s, tree.orbit[i]);
+            const auto u_y = transversal[position[y]];
+            for (std::uint32_t p = 0; p < places; ++p)
+                inverse[u_y[p]] = p;
+            bool identity = true;
+            for (std::size_t p = 0; p < places; ++p) {
+                h[p] = inverse[s[u_x[p]]];
+                identity = identity && h[p] == p;
+            }
+            if (!identity)
+                found.push_back(h);
+        }
+    }
+    std::ranges::sort(found);
+    const auto [first, last] = std::ranges::unique(found);
+    found.erase(first, last);
+
+    permutation_arena ret(places, found.size());
+    for (std::size_t i = 0; i < found.size(); ++i)
+        std::ranges::copy(found[i], ret.slot(i).begin());
+    return ret;
+}
+
+} // namespace permutations
@@ -0,0 +1,76 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace permutations {
+
+// Collects output in a large buffer and hands it to `std::fwrite` in big
+// blocks. Numbers are written with `std::to_chars`, so no temporary strings
+// are built for them.
+class output_buffer {
+    std::FILE *m_stream{};
+    std::vector<char> m_buffer{};
+    std::size_t m_used{};
+    bool m_error{};
+
+  public:
+    static constexpr std::size_t default_capacity = 1zu << 20;
+
+    explicit output_buffer(std::FILE *stream,
+                           std::size_t capacity = default_capacity)
+        : m_stream{stream}, m_buffer(std::max(capacity, 64zu)) {}
+    output_buffer(const output_buffer &) = delete;
+    output_buffer &operator=(const output_buffer &) = delete;
+    ~output_buffer() { flush(); }
+
+    void append(std::string_view text) {
+        while (!text.empty()) {
+            if (m_used == m_buffer.size())
+                flush();
+            const std::size_t n =
+                std::min(text.size(), m_buffer.size() - m_used);
+            std::memcpy(m_buffer.data() + m_used, text.data(), n);
+            m_used += n;
+            text.remove_prefix(n);
+        }
+    }
+
+    void append(char c) {
+        if (m_used == m_buffer.size())
+            flush();
+        m_buffer[m_used++] = c;
+    }
+
+    void append_number(std::integral auto number) {
+        // enough for any 64 bit integer with sign
+        static constexpr std::size_t max_digits = 24zu;
+        if (m_buffer.size() - m_used < max_digits)
+            flush();
+        char *const begin = m_buffer.data() + m_used;
+        auto result = std::to_chars(begin, begin + max_digits, number);
+        m_used += static_cast<std::size_t>(result.ptr - begin);
+    }
+
+    void append_bytes(const void *data, std::size_t size) {
+        append(std::string_view{static_cast<const char *>(data), size});
+    }
+
+    // Returns false, if any write so far failed.
+    bool flush() {
+        if (m_used != 0zu && !m_error &&
+            std::fwrite(m_buffer.data(), 1, m_used, m_stream) != m_used)
+            m_error = true;
+        m_used = 0;
+        return !m_error;
+    }
+
+    bool good() const { return !m_error; }
+};
+
+} // namespace permutations
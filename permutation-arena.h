@@ -0,0 +1,55 @@
+#pragma once
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace permutations {
+
+// Many permutations of the same degree, back to back in one allocation. The
+// entries are `Entry`s, see `compact_permutation_arena` for an arena, whose
+// entries are as narrow as the degree allows.
+template <std::unsigned_integral Entry> class basic_permutation_arena {
+    std::size_t m_places{};
+    std::vector<Entry> m_entries{};
+
+  public:
+    using entry_type = Entry;
+
+    basic_permutation_arena() = default;
+    explicit basic_permutation_arena(std::size_t places, std::size_t count = 0)
+        : m_places{places}, m_entries(places * count) {}
+
+    std::size_t places() const { return m_places; }
+    std::size_t size() const {
+        return m_places == 0zu ? 0zu : m_entries.size() / m_places;
+    }
+    void resize(std::size_t count) { m_entries.resize(m_places * count); }
+    void reserve(std::size_t count) { m_entries.reserve(m_places * count); }
+    // Appends one permutation and returns its (zeroed) entries.
+    std::span<Entry> append() {
+        m_entries.resize(m_entries.size() + m_places);
+        return std::span{m_entries}.last(m_places);
+    }
+    // Removes the last permutation.
+    void pop_back() {
+        assert(size() != 0zu);
+        m_entries.resize(m_entries.size() - m_places);
+    }
+
+    std::span<const Entry> operator[](std::size_t index) const {
+        assert(index < size());
+        return std::span{m_entries}.subspan(index * m_places, m_places);
+    }
+    std::span<Entry> slot(std::size_t index) {
+        assert(index < size());
+        return std::span{m_entries}.subspan(index * m_places, m_places);
+    }
+    std::span<const Entry> entries() const { return m_entries; }
+};
+
+using permutation_arena = basic_permutation_arena<std::uint32_t>;
+
+} // namespace permutations
@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "permutation-arena.h"
+
+namespace permutations {
+
+// Bulk input of permutations, one per line, in the notations that the tables
+// print: one-line notation like "BCAD" (the images of A, B, C, D), or cycle
+// notation like "(ABC)(D)", where fixed points may be left out. Empty lines
+// are skipped, a trailing '\r' is ignored. All permutations go into one
+// arena, without a `Permutation` per line, and every one of them is checked
+// to be a bijection. One letter per point means at most 26 points, so the
+// entries are bytes.
+
+struct permutation_parse_result {
+    basic_permutation_arena<std::uint8_t> permutations{};
+    // 1-based number of the first line that is no valid permutation of the
+    // common degree, or 0, if all lines were read
+    std::size_t error_line{};
+
+    explicit operator bool() const { return error_line == 0zu; }
+};
+
+namespace parser_detail {
+
+inline constexpr std::uint64_t ones = ~std::uint64_t{0} / 255u;
+inline constexpr std::uint64_t high_bits = ones * 128u;
+
+// Loads 8 chars into one integer, first char in the lowest byte.
+inline std::uint64_t load8(const char *p) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof word);
+    if constexpr (std::endian::native == std::endian::big)
+        word = std::byteswap(word);
+    return word;
+}
+
+// True, if all 8 chars of `word` are in 'A'..'Z'. Checks the bytes in
+// parallel: a byte below 'A' borrows into its high bit when 'A' is subtracted,
+// a byte above 'Z' carries into it when 127 - 'Z' is added.
+constexpr bool all_letters(std::uint64_t word) {
+    const std::uint64_t below = (word - ones * 'A') & ~word;
+    const std::uint64_t above = (word + ones * (127u - 'Z')) | word;
+    return ((below | above) & high_bits) == 0u;
+}
+
+// One-line notation: validates `line` 8 chars at a time and writes the
+// indices into `perm`. Every letter sets one bit of a mask, so the line is a
+// permutation iff the mask has `perm.size()` bits, all below bit `size`.
+inline bool parse_one_line(std::string_view line,
+                           std::span<std::uint8_t> perm) {
+    const std::size_t size = perm.size();
+    if (line.size() != size)
+        return false;
+    std::uint32_t seen = 0;
+    std::size_t i = 0;
+    for (; i + 8zu <= size; i += 8zu) {
+        const std::uint64_t word = load8(line.data() + i);
+        if (!all_letters(word))
+            return false;
+        // no byte borrows, all of them are at least 'A'
+        const std::uint64_t indices = word - ones * 'A';
+        for (std::size_t b = 0; b < 8zu; ++b) {
+            const auto index =
+                static_cast<std::uint8_t>((indices >> (8zu * b)) & 0xffu);
+            perm[i + b] = index;
+            seen |= std::uint32_t{1} << index;
+        }
+    }
+    for (; i < size; ++i) {
+        const auto index = static_cast<std::uint32_t>(
+            static_cast<unsigned char>(line[i]) - 'A');
+        if (index >= 26u)
+            return false;
+        perm[i] = static_cast<std::uint8_t>(index);
+        seen |= std::uint32_t{1} << index;
+    }
+    return std::cmp_equal(std::popcount(seen), size) && (seen >> size) == 0u;
+}
+
+// Cycle notation. Every letter may occur once; points that do not occur are
+// fixed.
+inline bool parse_cycles(std::string_view line,
+                         std::span<std::uint8_t> perm) {
+    const std::size_t size = perm.size();
+    for (std::size_t i = 0; i < size; ++i)
+        perm[i] = static_cast<std::uint8_t>(i);
+    std::uint32_t seen = 0;
+    std::size_t pos = 0;
+    while (pos < line.size()) {
+        if (line[pos] != '(')
+            return false;
+        const std::size_t close = line.find(')', pos + 1zu);
+        if (close == std::string_view::npos)
+            return false;
+        const std::string_view cycle = line.substr(pos + 1zu, close - pos - 1);
+        for (std::size_t j = 0; j < cycle.size(); ++j) {
+            const auto from = static_cast<std::uint32_t>(
+                static_cast<unsigned char>(cycle[j]) - 'A');
+            const auto to = static_cast<std::uint32_t>(
+                static_cast<unsigned char>(
+                    cycle[j + 1zu == cycle.size() ? 0zu : j + 1zu]) -
+                'A');
+            if (from >= size || to >= size ||
+                (seen & (std::uint32_t{1} << from)) != 0u)
+                return false;
+            seen |= std::uint32_t{1} << from;
+            perm[from] = static_cast<std::uint8_t>(to);
+        }
+        pos = close + 1zu;
+    }
+    return true;
+}
+
+// Degree of the first line: its length in one-line notation, the largest
+// letter plus one in cycle notation.
+inline std::size_t guess_places(std::string_view line) {
+    if (line.empty() || line.front() != '(')
+        return line.size();
+    std::size_t places = 0;
+    for (const char c : line)
+        if (c >= 'A' && c <= 'Z')
+            places = std::max(places, static_cast<std::size_t>(c - 'A' + 1));
+    return places;
+}
+
+} // namespace parser_detail
+
+// Parses all lines of `text`. With `places` = 0 the degree is taken from the
+// first non-empty line. At most 26 places, one letter each.
+[[nodiscard]] inline permutation_parse_result
+parse_permutations(std::string_view text, std::size_t places = 0) {
+    permutation_parse_result ret{};
+    bool first = true;
+    std::size_t line_number = 0;
+    while (!text.empty()) {
+        ++line_number;
+        const std::size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size()
+                                                         : end + 1zu);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty())
+            continue;
+
+        if (first) {
+            first = false;
+            if (places == 0zu)
+                places = parser_detail::guess_places(line);
+            if (places == 0zu || places > 26zu) {
+                ret.error_line = line_number;
+                return ret;
+            }
+            ret.permutations = basic_permutation_arena<std::uint8_t>(places);
+            // a guess, assuming one-line notation in all lines
+            ret.permutations.reserve(text.size() / (places + 1zu) + 1zu);
+        }
+
+        auto perm = ret.permutations.append();
+        const bool ok = line.front() == '('
+                            ? parser_detail::parse_cycles(line, perm)
+                            : parser_detail::parse_one_line(line, perm);
+        if (!ok) {
+            ret.permutations.pop_back();
+            ret.error_line = line_number;
+            return ret;
+        }
+    }
+    return ret;
+}
+
+// Reads all of `stream`, e.g. a file or stdin, in large blocks and parses it
+// like `parse_permutations`. A read error is reported at the line after the
+// last complete one.
+[[nodiscard]] inline permutation_parse_result
+read_permutations(std::FILE *stream, std::size_t places = 0) {
+    std::string text{};
+    constexpr std::size_t block = 1zu << 20;
+    std::size_t used = 0;
+    while (true) {
+        text.resize(used + block);
+        const std::size_t n = std::fread(text.data() + used, 1, block, stream);
+        used += n;
+        if (n < block)
+            break;
+    }
+    text.resize(used);
+    auto ret = parse_permutations(text, places);
+    if (ret && std::ferror(stream))
+        ret.error_line = static_cast<std::size_t>(std::ranges::count(
+                             text, '\n')) +
+                         1zu;
+    return ret;
+}
+
+} // namespace permutations
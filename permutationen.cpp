@@ -1,22 +1,48 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <bitset>
 #include <cassert>
+#include <charconv>
 #include <concepts>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <format>
 #include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <print>
 #include <ranges>
 #include <set>
 #include <span>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "group-interface.h"
 #include "2by2matrix.h"
+#include "cycle-types.h"
+#include "permutation-arena.h"
+#include "compact-permutations.h"
+#include "permutation-parser.h"
+#include "random-permutations.h"
+#include "multiset-permutations.h"
+#include "tabulated-group.h"
+#include "table-export.h"
+#include "group-store.h"
+#include "orbits.h"
+#include "large-permutations.h"
+#include "product-groups.h"
+#include "cayley-graph.h"
+#include "phase-trace.h"
 
 namespace permutations {
 
@@ -84,10 +110,14 @@ static std::optional<char> index_to_char(size_t index, std::size_t size) {
 class PermutationException : public std::exception {};
 struct symetric_group;
 
-struct PermutationView;
-class Permutation {
+// Permutations of `size()` points, perm[i] is the image of i. The entries are
+// 8, 16 or 32 bits wide, see `entry_width_for`; `Permutation` and
+// `PermutationView` are the 32 bit ones, that the group configs use.
+template <std::unsigned_integral Entry> struct basic_permutation_view;
+
+template <std::unsigned_integral Entry> class basic_permutation {
   public:
-    typedef uint32_t uint_t;
+    typedef Entry uint_t;
     typedef std::span<const uint_t> readonly_span;
     typedef std::span<uint_t> span;
 
@@ -96,9 +126,11 @@ class Permutation {
     span m_span{};
 
   public:
-    Permutation() = default;
-    Permutation(uint_t places, bool make_identity_perm = false)
+    basic_permutation() = default;
+    basic_permutation(std::size_t places, bool make_identity_perm = false)
         : m_data{new uint_t[places]{}}, m_span{m_data.get(), places} {
+        if (!entry_fits<uint_t>(places))
+            throw PermutationException();
 
         if (make_identity_perm) {
             auto range =
@@ -106,103 +138,118 @@ class Permutation {
             std::ranges::copy(range, m_span.begin());
         }
     }
-    Permutation(std::initializer_list<uint_t> init)
+    basic_permutation(std::initializer_list<uint_t> init)
         : m_data{new uint_t[init.size()]{}}, m_span{m_data.get(), init.size()} {
 
         std::ranges::copy(init, m_span.begin());
     }
-    Permutation(std::ranges::sized_range auto &&range)
-        requires std::same_as<std::ranges::range_value_t<decltype(range)>,
-                              uint_t>
-        : m_data{new uint_t[range.size()]{}},
-          m_span{m_data.get(), range.size()} {
-        std::ranges::copy(range, m_span.begin());
+    // copies a view of the same width, that always fits
+    basic_permutation(basic_permutation_view<uint_t> view)
+        : m_data{new uint_t[view.size()]{}}, m_span{m_data.get(), view.size()} {
+        std::ranges::copy(view, m_span.begin());
+    }
+    // from entries of any width, e.g. from a `compact_permutation_arena`;
+    // throws, if an entry does not fit into `uint_t`
+    template <std::ranges::sized_range R>
+        requires std::unsigned_integral<std::ranges::range_value_t<R>>
+    explicit basic_permutation(R &&range)
+        : m_data{new uint_t[std::ranges::size(range)]{}},
+          m_span{m_data.get(), std::ranges::size(range)} {
+        auto out = m_span.begin();
+        for (const auto entry : range) {
+            if (!std::in_range<uint_t>(entry))
+                throw PermutationException();
+            *out++ = static_cast<uint_t>(entry);
+        }
     }
 
-    Permutation(const Permutation &other)
+    basic_permutation(const basic_permutation &other)
         : m_data{new uint_t[other.m_span.size()]{}},
           m_span{m_data.get(), other.m_span.size()} {
         std::ranges::copy(other.m_span, m_span.begin());
     }
-    Permutation(Permutation &&) = default;
+    basic_permutation(basic_permutation &&) = default;
 
-    Permutation &operator=(const Permutation &other) {
-        *this = Permutation(other);
+    basic_permutation &operator=(const basic_permutation &other) {
+        *this = basic_permutation(other);
         return *this;
     }
-    Permutation &operator=(Permutation &&) = default;
+    basic_permutation &operator=(basic_permutation &&) = default;
 
-    ~Permutation() = default;
+    ~basic_permutation() = default;
 
     constexpr span get_span() { return m_span; }
     constexpr readonly_span get_readonly_span() const {
         return std::span<const uint_t>{this->m_span};
     }
-    constexpr PermutationView get_perm_view() const;
+    constexpr basic_permutation_view<uint_t> get_perm_view() const {
+        return basic_permutation_view<uint_t>{this->get_readonly_span()};
+    }
 
-    constexpr std::string to_string() const;
+    constexpr std::string to_string() const {
+        return this->get_perm_view().to_string();
+    }
 
     constexpr operator readonly_span() const { return get_readonly_span(); }
     constexpr operator span() { return get_span(); }
-    constexpr operator PermutationView() const;
+    constexpr operator basic_permutation_view<uint_t>() const {
+        return get_perm_view();
+    }
     constexpr explicit operator symetric_group() const;
 
     constexpr std::size_t size() const { return m_span.size(); }
 };
 
-struct PermutationView : public Permutation::readonly_span {
+template <std::unsigned_integral Entry>
+struct basic_permutation_view : public std::span<const Entry> {
   private:
-    typedef Permutation::readonly_span base;
+    typedef std::span<const Entry> base;
 
   public:
     // inherit ctors
     using base::base;
 
     // ctor
-    constexpr PermutationView() : base() {}
-    //constexpr PermutationView(const Permutation& perm)
-    //    : base(perm.get_readonly_span()) {}
+    constexpr basic_permutation_view() : base() {}
 
     // copy ctor, assignment
-    constexpr PermutationView(const PermutationView &) = default;
-    constexpr PermutationView &operator=(const PermutationView &) = default;
-
-    // move ctor, assignment
-    //PermutationView(PermutationView&&) = default;
-    //PermutationView& operator=(PermutationView&&) = default;
+    constexpr basic_permutation_view(const basic_permutation_view &) = default;
+    constexpr basic_permutation_view &
+    operator=(const basic_permutation_view &) = default;
 
     // ctor, assignment from base
-    constexpr PermutationView(const base &b) : base(b) {}
-    constexpr PermutationView &operator=(const base &b) {
+    constexpr basic_permutation_view(const base &b) : base(b) {}
+    constexpr basic_permutation_view &operator=(const base &b) {
         this->base::operator=(b);
         return *this;
     }
 
     // dtor
-    constexpr ~PermutationView() = default;
+    constexpr ~basic_permutation_view() = default;
 
-    constexpr base get_readonly_span() { return *this; }
+    constexpr base get_readonly_span() const { return *this; }
 
-    constexpr bool operator==(const PermutationView &other) const {
+    // memcmp is vectorized by every standard library
+    constexpr bool operator==(const basic_permutation_view &other) const {
         if (other.size() != this->size())
             return false;
-        auto other_it = other.begin();
-        for (auto i : *this) {
-            if (i != *(other_it++))
-                return false;
+        if consteval {
+            return std::ranges::equal(*this, other);
+        } else {
+            return this->empty() ||
+                   std::memcmp(this->data(), other.data(),
+                               this->size_bytes()) == 0;
         }
-        return true;
     }
 
     constexpr std::string to_string() const {
         const std::size_t size = this->size();
-        auto view = *this | std::views::transform(
-                                [size](Permutation::uint_t i) -> char {
-                                    auto opt = index_to_char(i, size);
-                                    if (!opt)
-                                        throw PermutationException();
-                                    return *opt;
-                                });
+        auto view = *this | std::views::transform([size](Entry i) -> char {
+                        auto opt = index_to_char(i, size);
+                        if (!opt)
+                            throw PermutationException();
+                        return *opt;
+                    });
         static_assert(
             std::same_as<std::ranges::range_value_t<decltype(view)>, char>);
         return view | std::ranges::to<std::string>();
@@ -211,40 +258,81 @@ struct PermutationView : public Permutation::readonly_span {
     constexpr explicit operator symetric_group() const;
 };
 
-constexpr Permutation::operator PermutationView() const {
-    return PermutationView{this->get_readonly_span()};
-}
-constexpr PermutationView Permutation::get_perm_view() const {
-    return this->operator PermutationView();
-}
+template <std::unsigned_integral Entry>
+basic_permutation_view(const basic_permutation<Entry> &)
+    -> basic_permutation_view<Entry>;
+template <std::unsigned_integral Entry>
+basic_permutation_view(std::span<const Entry>) -> basic_permutation_view<Entry>;
+template <std::unsigned_integral Entry>
+basic_permutation_view(std::span<Entry>) -> basic_permutation_view<Entry>;
 
-constexpr std::string Permutation::to_string() const {
-    return this->operator PermutationView().to_string();
-}
-inline constexpr auto cmp_less = [](const Permutation &a,
-                                    const Permutation &b) -> bool {
-    if (a.size() < b.size())
-        return true;
-    if (a.size() > b.size())
-        return false;
+using Permutation = basic_permutation<std::uint32_t>;
+using PermutationView = basic_permutation_view<std::uint32_t>;
 
-    assert(a.size() == b.size());
-    const auto sa = a.get_readonly_span();
-    const auto sb = b.get_readonly_span();
+namespace concepts {
+// Permutations, views and spans of entries of any width.
+template <typename P>
+concept permutation_of_any_width_c =
+    requires(const P &p) { basic_permutation_view{p}; };
+} // namespace concepts
 
-    for (std::size_t i = 0zu; i < a.size(); ++i) {
-        if (sa[i] < sb[i])
-            return true;
-        else if (sa[i] == sb[i])
-            continue;
-        else if (sa[i] > sb[i])
-            return false;
+// Shorter permutations first, then lexicographic. Takes views of any width,
+// so that comparing views does not copy them into `Permutation`s. Equal
+// blocks of entries of the same width are skipped with memcmp; only the
+// block with the first difference is searched entry by entry.
+inline constexpr auto cmp_less =
+    [](const concepts::permutation_of_any_width_c auto &x,
+       const concepts::permutation_of_any_width_c auto &y) -> bool {
+    const basic_permutation_view a{x};
+    const basic_permutation_view b{y};
+    if (a.size() != b.size())
+        return a.size() < b.size();
+
+    std::size_t i = 0zu;
+    if constexpr (std::same_as<decltype(a), decltype(b)>) {
+        constexpr std::size_t block = 8zu;
+        if !consteval {
+            for (; i + block <= a.size(); i += block) {
+                if (std::memcmp(a.data() + i, b.data() + i,
+                                block * sizeof(a[0])) != 0)
+                    break;
+            }
+        }
+    }
+    for (; i < a.size(); ++i) {
+        if (a[i] != b[i])
+            return std::cmp_less(a[i], b[i]);
     }
     return false;
 };
 typedef decltype(cmp_less) cmp_less_t;
 typedef std::set<Permutation, cmp_less_t> set;
 
+// 64 bit fingerprint of the size and the entries. Equal permutations have
+// equal fingerprints, so different fingerprints prove that two permutations
+// differ; equal ones have to be confirmed by comparing the entries.
+template <std::ranges::sized_range R>
+constexpr std::uint64_t fingerprint_of_entries(R &&entries) {
+    std::uint64_t h = 0x9e3779b97f4a7c15u ^ std::ranges::size(entries);
+    for (const auto entry : entries)
+        h = std::rotl(h ^ entry, 27) * 0xff51afd7ed558ccdu;
+    // finalizer of splitmix64
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9u;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebu;
+    return h ^ (h >> 31);
+}
+
+constexpr std::uint64_t permutation_fingerprint(PermutationView perm) {
+    return fingerprint_of_entries(perm);
+}
+
+constexpr bool is_identity(PermutationView perm) {
+    for (std::size_t i = 0; i < perm.size(); ++i)
+        if (perm[i] != i)
+            return false;
+    return true;
+}
+
 struct symetric_group{
     using element_type = Permutation;
     using element_view_type = PermutationView;
@@ -253,11 +341,13 @@ struct symetric_group{
 };
 static_assert(group_config_c<symetric_group>);
 
-constexpr Permutation::operator symetric_group() const {
+template <std::unsigned_integral Entry>
+constexpr basic_permutation<Entry>::operator symetric_group() const {
     return symetric_group{.places = this->m_span.size()};
 }
 
-constexpr PermutationView::operator symetric_group() const {
+template <std::unsigned_integral Entry>
+constexpr basic_permutation_view<Entry>::operator symetric_group() const {
     return symetric_group{.places = this->size()};
 }
 
@@ -304,9 +394,10 @@ concept range_of_PermutationView_likes_c =
     PermutationView_like_c<std::ranges::range_value_t<R>>;
 } //namespace concepts
 
-template <>
+// The cycle notation of a permutation of any width, e.g. (ACB)(D).
 std::optional<std::string>
-get_other_representation<symetric_group>(const PermutationView span) {
+cycle_notation(const concepts::permutation_of_any_width_c auto &perm) {
+    const basic_permutation_view span{perm};
     // Print permutations like in the book "Elementar(st)e Gruppentheorie"
     // by Tobias Glosauer,
     // Chapter 3 "Gruppen ohne Ende",
@@ -342,13 +433,19 @@ get_other_representation<symetric_group>(const PermutationView span) {
     return ret;
 }
 
+template <>
+std::optional<std::string>
+get_other_representation<symetric_group>(const PermutationView span) {
+    return cycle_notation(span);
+}
+
 } // namespace permutations
 
 // https://fmt.dev/latest/api.html#formatting-user-defined-types
 // https://en.cppreference.com/w/cpp/utility/format/formatter
 // template specialization must be in global namespace
-template <>
-struct std::formatter<permutations::PermutationView, char> {
+template <std::unsigned_integral Entry>
+struct std::formatter<permutations::basic_permutation_view<Entry>, char> {
 
     unsigned repr_a : 1 = 0;
     unsigned repr_b : 1 = 0;
@@ -380,8 +477,9 @@ struct std::formatter<permutations::PermutationView, char> {
     }
 
     template <typename FmtContext>
-    FmtContext::iterator format(const permutations::PermutationView &perm_view,
-                                FmtContext &ctx) const {
+    FmtContext::iterator
+    format(const permutations::basic_permutation_view<Entry> &perm_view,
+           FmtContext &ctx) const {
         using namespace permutations;
         const std::size_t size = perm_view.size();
 
@@ -394,7 +492,7 @@ struct std::formatter<permutations::PermutationView, char> {
 
         if (repr_a) {
             auto view = perm_view | std::views::transform(
-                                        [size](Permutation::uint_t i) -> char {
+                                        [size](Entry i) -> char {
                                             auto opt = index_to_char(i, size);
                                             if (!opt)
                                                 throw PermutationException();
@@ -409,8 +507,7 @@ struct std::formatter<permutations::PermutationView, char> {
             out = std::ranges::copy(std::string_view{" - "}, out).out;
         }
         if (repr_b) {
-            auto other_repr_opt =
-                get_other_representation<symetric_group>(perm_view);
+            auto other_repr_opt = cycle_notation(perm_view);
             if (!other_repr_opt.has_value())
                 throw PermutationException();
             out = std::ranges::copy(*other_repr_opt, out).out;
@@ -420,9 +517,11 @@ struct std::formatter<permutations::PermutationView, char> {
 };
 static_assert(std::formattable<permutations::PermutationView, char>);
 
-template <> struct std::formatter<permutations::Permutation, char> {
+template <std::unsigned_integral Entry>
+struct std::formatter<permutations::basic_permutation<Entry>, char> {
 
-    std::formatter<permutations::PermutationView> view_formatter{};
+    std::formatter<permutations::basic_permutation_view<Entry>>
+        view_formatter{};
 
     template <class ParseContext>
     constexpr ParseContext::iterator parse(ParseContext &ctx) {
@@ -430,70 +529,317 @@ template <> struct std::formatter<permutations::Permutation, char> {
     }
 
     template <typename FmtContext>
-    FmtContext::iterator format(const permutations::Permutation &perm,
-                                FmtContext &ctx) const {
-        return view_formatter.format(permutations::PermutationView{perm}, ctx);
+    FmtContext::iterator
+    format(const permutations::basic_permutation<Entry> &perm,
+           FmtContext &ctx) const {
+        return view_formatter.format(perm.get_perm_view(), ctx);
     }
 };
 static_assert(std::formattable<permutations::Permutation, char>);
 
 namespace permutations {
 
+// Writes the product a ∘ b into `result` without allocating. `result` must not
+// overlap `a` or `b`; the widths of all three may differ. Large permutations
+// are composed by `number_of_threads` threads, see large-permutations.h.
+template <std::unsigned_integral Out>
+[[nodiscard]] bool compose_permutations_into(
+    std::span<Out> result, const concepts::permutation_of_any_width_c auto &a,
+    const concepts::permutation_of_any_width_c auto &b,
+    std::size_t number_of_threads = std::thread::hardware_concurrency()) {
+    const basic_permutation_view a_view{a};
+    const basic_permutation_view b_view{b};
+    if (a_view.size() >= blocked_permutation_threshold)
+        return blocked_compose_into(result, a_view.get_readonly_span(),
+                                    b_view.get_readonly_span(),
+                                    number_of_threads);
+    return compose_into(result, a_view.get_readonly_span(),
+                        b_view.get_readonly_span());
+}
+
 // Composition of permutations as if they are functions:
 // a ∘ b
 // (a∘b)(i) = a(b(i))
+template <std::unsigned_integral Entry>
+std::optional<basic_permutation<Entry>>
+compose_permutations(basic_permutation_view<Entry> a,
+                     basic_permutation_view<Entry> b) {
+    if (a.size() != b.size())
+        return std::nullopt;
+    std::optional<basic_permutation<Entry>> result(std::in_place, a.size());
+    if (!compose_permutations_into(result->get_span(), a, b))
+        return std::nullopt;
+    return result;
+}
+
 template<>
 std::optional<typename symetric_group::element_type>
 compose_permutations<symetric_group>(symetric_group::element_view_type a,
                      symetric_group::element_view_type b) {
-    if (a.size() != b.size())
+    return compose_permutations(a, b);
+}
+
+// Product of all permutations in `range` from left to right, like
+// `compose_permutations<symetric_group>(range)`. It is accumulated in the two
+// ping-pong buffers `result` and `scratch`, so nothing is allocated. The
+// product ends up in `result`.
+template <concepts::range_of_PermutationView_likes_c R>
+[[nodiscard]] bool compose_permutations_into(
+    Permutation::span result, Permutation::span scratch, R &&range,
+    std::size_t number_of_threads = std::thread::hardware_concurrency()) {
+    if (scratch.size() != result.size())
+        return false;
+    Permutation::span acc = result;
+    Permutation::span next = scratch;
+    bool first = true;
+    for (const auto &perm : range) {
+        const PermutationView view = perm;
+        if (first) {
+            if (view.size() != acc.size())
+                return false;
+            std::ranges::copy(view, acc.begin());
+            first = false;
+            continue;
+        }
+        if (!compose_permutations_into(next, PermutationView{acc}, view,
+                                       number_of_threads))
+            return false;
+        std::swap(acc, next);
+    }
+    if (first)
+        return false;
+    if (acc.data() != result.data())
+        std::ranges::copy(acc, result.begin());
+    return true;
+}
+
+// From this many entries of all factors together on, `compose_permutations`
+// of a random access range splits the word among threads, see
+// `compose_permutations_parallel`.
+inline constexpr std::size_t parallel_compose_threshold = 1zu << 20;
+
+// Balanced parallel reduction for long words: the factors are split into
+// consecutive chunks, which are folded concurrently with
+// `compose_permutations_into`. Then neighbouring partial products are
+// combined pairwise, level by level, until one product is left. Every worker
+// gets its share of `number_of_threads` for the blocked kernels of large
+// permutations, so there are never more than about that many threads.
+template <std::ranges::random_access_range R>
+    requires concepts::range_of_PermutationView_likes_c<R>
+std::optional<Permutation>
+compose_permutations_parallel(R &&range,
+                              std::size_t number_of_threads =
+                                  std::thread::hardware_concurrency()) {
+    using difference_t = std::ranges::range_difference_t<R>;
+    const auto length = static_cast<std::size_t>(std::ranges::distance(range));
+    if (length == 0zu)
+        return std::nullopt;
+    const auto &first = *std::ranges::begin(range);
+    const std::size_t size = PermutationView{first}.size();
+    const std::size_t chunks = std::clamp(number_of_threads, 1zu, length);
+    const std::size_t threads_per_chunk =
+        std::max(number_of_threads / chunks, 1zu);
+
+    std::vector<Permutation> partial{};
+    partial.reserve(chunks);
+    for (std::size_t c = 0; c < chunks; ++c)
+        partial.emplace_back(size);
+    std::vector<char> ok(chunks, false);
+    {
+        std::vector<std::jthread> threads{};
+        threads.reserve(chunks);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            threads.emplace_back([&, c] {
+                const std::size_t lo = length * c / chunks;
+                const std::size_t hi = length * (c + 1zu) / chunks;
+                Permutation scratch(size);
+                ok[c] = compose_permutations_into(
+                    partial[c], scratch,
+                    std::ranges::subrange(
+                        std::ranges::begin(range) + difference_t(lo),
+                        std::ranges::begin(range) + difference_t(hi)),
+                    threads_per_chunk);
+            });
+        }
+    }
+    if (!std::ranges::all_of(ok, [](char b) { return b != 0; }))
         return std::nullopt;
-    std::size_t size = a.size();
 
-    std::optional<Permutation> result(std::in_place, size);
-    auto span = result->get_span();
-    for (std::size_t i = 0; i < size; ++i) {
-        auto new_index = b[i]; // As if `b` was a (mathematical) function: b(i).
-        if (std::cmp_greater_equal(new_index, size))
+    for (std::size_t stride = 1zu; stride < chunks; stride *= 2zu) {
+        const std::size_t pairs =
+            (chunks - stride + 2zu * stride - 1zu) / (2zu * stride);
+        const std::size_t threads_per_pair =
+            std::max(number_of_threads / pairs, 1zu);
+        std::vector<std::jthread> threads{};
+        for (std::size_t c = 0; c + stride < chunks; c += 2zu * stride) {
+            threads.emplace_back([&, c] {
+                Permutation product(size);
+                ok[c] = compose_permutations_into(
+                    product.get_span(), partial[c], partial[c + stride],
+                    threads_per_pair);
+                partial[c] = std::move(product);
+            });
+        }
+        threads.clear();
+        if (!std::ranges::all_of(ok, [](char b) { return b != 0; }))
             return std::nullopt;
-        span[i] = a[new_index];
     }
-    return result;
+    return std::move(partial[0]);
 }
 
 template <group_config_c group_config_t>
 std::optional<typename group_config_t::element_type>
 compose_permutations(range_of_element_view_likes_c<group_config_t> auto &&range) {
 
-    std::optional<typename group_config_t::element_type> opt;
-    for (const auto &perm : range) {
-        if (!opt.has_value()) {
-            opt.emplace(perm);
-            continue;
+    if constexpr (std::same_as<group_config_t, symetric_group>) {
+        if constexpr (std::ranges::random_access_range<decltype(range)>) {
+            const auto length =
+                static_cast<std::size_t>(std::ranges::distance(range));
+            if (length >= 2zu &&
+                length * PermutationView{*std::ranges::begin(range)}.size() >=
+                    parallel_compose_threshold)
+                return compose_permutations_parallel(range);
+        }
+        // Fold into two ping-pong buffers instead of allocating a new
+        // permutation for every factor.
+        std::optional<Permutation> opt;
+        Permutation scratch;
+        for (const auto &perm : range) {
+            const PermutationView view = perm;
+            if (!opt.has_value()) {
+                opt.emplace(view.size());
+                scratch = Permutation(view.size());
+                std::ranges::copy(view, opt->get_span().begin());
+                continue;
+            }
+            if (!compose_permutations_into(scratch.get_span(), *opt, view))
+                return std::nullopt;
+            std::swap(*opt, scratch);
         }
-        opt = compose_permutations<group_config_t>(*opt, perm);
-        if (!opt.has_value()) {
-            return opt;
+        return opt;
+    } else {
+        std::optional<typename group_config_t::element_type> opt;
+        for (const auto &perm : range) {
+            if (!opt.has_value()) {
+                opt.emplace(perm);
+                continue;
+            }
+            opt = compose_permutations<group_config_t>(*opt, perm);
+            if (!opt.has_value()) {
+                return opt;
+            }
         }
+        return opt;
     }
-    return opt;
 }
 
-Permutation inverse(const Permutation::readonly_span a) {
-    Permutation result(a.size());
+// The inverse of `perm`, which has to be a permutation, with its width.
+auto inverse(const concepts::permutation_of_any_width_c auto &perm) {
+    const auto a = basic_permutation_view{perm}.get_readonly_span();
+    basic_permutation<typename decltype(a)::value_type> result(a.size());
     auto span = result.get_span();
-
-    for (Permutation::uint_t i{}; std::cmp_less(i, a.size()); ++i) {
-        auto j = a[i];
-        assert(std::cmp_less(j, a.size()));
-        span[j] = i;
+    if (a.size() >= blocked_permutation_threshold) {
+        [[maybe_unused]] const bool ok = blocked_inverse_into(span, a);
+        assert(ok);
+        return result;
     }
+    inverse_into(span, a);
     return result;
 }
 
-static void print_span(std::span<char> span) {
-    std::string_view view(span.data(), span.size());
-    std::print("|{}|\n", view);
+// True, if `perm` is a bijection of {0, ..., size-1}, see
+// `entries_are_permutation`.
+bool is_permutation(const concepts::permutation_of_any_width_c auto &perm) {
+    return entries_are_permutation(
+        basic_permutation_view{perm}.get_readonly_span());
+}
+
+// A view of a permutation, that has been checked by `is_permutation` once.
+// The operations on validated permutations below need no checks per element
+// and return plain values; only the untrusted input has to go through
+// `validate`.
+class ValidatedPermutationView : public PermutationView {
+    explicit constexpr ValidatedPermutationView(PermutationView perm)
+        : PermutationView(perm) {}
+
+  public:
+    static std::optional<ValidatedPermutationView>
+    validate(PermutationView perm) {
+        if (!is_permutation(perm))
+            return std::nullopt;
+        return ValidatedPermutationView{perm};
+    }
+    // For data that is valid by construction, e.g. the elements of a
+    // `stored_group` from `group_store::load`, or products of validated
+    // permutations. Only checked in debug builds.
+    static ValidatedPermutationView assume_valid(PermutationView perm) {
+        assert(is_permutation(perm));
+        return ValidatedPermutationView{perm};
+    }
+};
+
+// Owning counterpart of `ValidatedPermutationView`.
+class ValidatedPermutation {
+    Permutation m_perm{};
+
+    explicit ValidatedPermutation(Permutation perm)
+        : m_perm{std::move(perm)} {}
+
+  public:
+    static std::optional<ValidatedPermutation> validate(Permutation perm) {
+        if (!is_permutation(perm))
+            return std::nullopt;
+        return ValidatedPermutation{std::move(perm)};
+    }
+    static ValidatedPermutation identity(Permutation::uint_t places) {
+        return ValidatedPermutation{Permutation(places, true)};
+    }
+    // see `ValidatedPermutationView::assume_valid`
+    static ValidatedPermutation assume_valid(Permutation perm) {
+        assert(is_permutation(perm));
+        return ValidatedPermutation{std::move(perm)};
+    }
+
+    const Permutation &get() const { return m_perm; }
+    std::size_t size() const { return m_perm.size(); }
+    Permutation release() && { return std::move(m_perm); }
+    std::string to_string() const { return m_perm.to_string(); }
+    operator ValidatedPermutationView() const {
+        return ValidatedPermutationView::assume_valid(m_perm);
+    }
+};
+
+// a ∘ b. Only the sizes are compared, a mismatch throws.
+ValidatedPermutation compose(ValidatedPermutationView a,
+                             ValidatedPermutationView b) {
+    const std::size_t size = a.size();
+    if (b.size() != size)
+        throw PermutationException();
+    Permutation result(static_cast<Permutation::uint_t>(size));
+    auto span = result.get_span();
+    if (size >= blocked_permutation_threshold) {
+        [[maybe_unused]] const bool ok = blocked_compose_into(
+            span, Permutation::readonly_span{a}, Permutation::readonly_span{b});
+        assert(ok);
+        return ValidatedPermutation::assume_valid(std::move(result));
+    }
+    [[maybe_unused]] const bool ok = compose_into(
+        span, Permutation::readonly_span{a}, Permutation::readonly_span{b});
+    assert(ok);
+    return ValidatedPermutation::assume_valid(std::move(result));
+}
+
+ValidatedPermutation inverse(ValidatedPermutationView a) {
+    Permutation result(static_cast<Permutation::uint_t>(a.size()));
+    auto span = result.get_span();
+    if (a.size() >= blocked_permutation_threshold) {
+        [[maybe_unused]] const bool ok =
+            blocked_inverse_into(span, Permutation::readonly_span{a});
+        assert(ok);
+        return ValidatedPermutation::assume_valid(std::move(result));
+    }
+    inverse_into(span, Permutation::readonly_span{a});
+    return ValidatedPermutation::assume_valid(std::move(result));
 }
 
 template<>
@@ -501,46 +847,292 @@ symetric_group::element_type get_identity<symetric_group>(symetric_group g) {
     return Permutation(g.places, true);
 }
 
-template <group_config_c gc>
-std::optional<std::size_t> get_order(typename gc::element_view_type view) {
-    gc config_obj = static_cast<gc>(view);
-    const typename gc::element_type identity_permutation =
-        get_identity<gc>(config_obj);
-    const typename gc::element_view_type identity = identity_permutation;
-    typename gc::element_type perm = identity_permutation;
-
-    std::size_t ret = 0;
+// Walks the cycle of `perm` that contains `start`. Returns its length, or
+// std::nullopt, if `perm` is not a permutation, i.e. the walk leaves the
+// range, runs into an element marked as visited in `visited` or does not come
+// back within `perm.size()` steps.
+template <std::unsigned_integral Entry>
+static std::optional<std::size_t>
+cycle_length(basic_permutation_view<Entry> perm, std::size_t start,
+             Permutation::readonly_span visited,
+             Permutation::uint_t unvisited) {
+    const std::size_t size = perm.size();
+    std::size_t length = 0;
+    std::size_t x = start;
     do {
-        auto perm_opt = compose_permutations<gc>(view, perm);
-        if (!perm_opt) {
+        if (std::cmp_greater_equal(perm[x], size) || visited[x] != unvisited ||
+            length == size)
             return std::nullopt;
+        x = perm[x];
+        ++length;
+    } while (x != start);
+    return length;
+}
+
+// Writes perm^k into `result` in O(n): on a cycle of length L, the k-th power
+// moves every point k mod L steps along the cycle. Negative `k` are powers of
+// the inverse. Returns false, if `perm` is not a permutation.
+template <std::integral Integer>
+[[nodiscard]] bool power_into(Permutation::span result, PermutationView perm,
+                              Integer k) {
+    const std::size_t size = perm.size();
+    if (result.size() != size)
+        return false;
+    // `size` is no valid entry, so it marks points that are not yet written
+    const auto unvisited = static_cast<Permutation::uint_t>(size);
+    std::ranges::fill(result, unvisited);
+
+    for (std::size_t start = 0; start < size; ++start) {
+        if (result[start] != unvisited)
+            continue;
+        auto length_opt = cycle_length(perm, start, result, unvisited);
+        if (!length_opt)
+            return false;
+        // wide enough for both, L may not fit into `Integer`
+        using Unsigned =
+            std::common_type_t<std::size_t, std::make_unsigned_t<Integer>>;
+        const Unsigned length = *length_opt;
+        std::size_t steps;
+        if constexpr (std::is_signed_v<Integer>) {
+            // (k mod L) in [0, L) also for negative k
+            const auto abs_k = static_cast<Unsigned>(
+                static_cast<std::make_unsigned_t<Integer>>(
+                    k < 0 ? -(k + 1) : k));
+            steps = static_cast<std::size_t>(
+                k < 0 ? length - 1u - abs_k % length : abs_k % length);
+        } else {
+            steps = static_cast<std::size_t>(static_cast<Unsigned>(k) %
+                                             length);
         }
-        perm = std::move(*perm_opt);
-        ret += 1;
-    } while (typename gc::element_view_type{perm} != identity);
+
+        std::size_t image = start;
+        for (std::size_t i = 0; i < steps; ++i)
+            image = perm[image];
+        std::size_t x = start;
+        do {
+            result[x] = static_cast<Permutation::uint_t>(image);
+            x = perm[x];
+            image = perm[image];
+        } while (x != start);
+    }
+    return true;
+}
+
+template <std::integral Integer>
+std::optional<Permutation> power(PermutationView perm, Integer k) {
+    std::optional<Permutation> result(std::in_place, perm.size());
+    if (!power_into(result->get_span(), perm, k))
+        return std::nullopt;
+    return result;
+}
+
+// The order of a permutation of any width is the least common multiple of
+// its cycle lengths.
+std::optional<std::size_t>
+permutation_order(const concepts::permutation_of_any_width_c auto &p) {
+    const basic_permutation_view perm{p};
+    const std::size_t size = perm.size();
+    // one bit per point would do, but the entries of a permutation are
+    // reused as marks like in `power_into`; 32 bit ones, as `size` itself
+    // may not fit into the entries of `perm`
+    Permutation visited(size);
+    auto marks = visited.get_span();
+    const auto unvisited = static_cast<Permutation::uint_t>(size);
+    std::ranges::fill(marks, unvisited);
+
+    std::size_t order = 1;
+    for (std::size_t start = 0; start < size; ++start) {
+        if (marks[start] != unvisited)
+            continue;
+        auto length_opt = cycle_length(perm, start, marks, unvisited);
+        if (!length_opt)
+            return std::nullopt;
+        for (std::size_t x = start; marks[x] == unvisited; x = perm[x])
+            marks[x] = 0;
+        order = std::lcm(order, *length_opt);
+    }
+    return order;
+}
+
+// The sign of a permutation, +1 for even and -1 for odd ones, in O(n): a
+// permutation with c cycles, fixed points included, is a product of n - c
+// transpositions. Returns std::nullopt, if `perm` is not a permutation.
+std::optional<int> permutation_sign(PermutationView perm) {
+    const std::size_t size = perm.size();
+    std::vector<bool> visited(size);
+    std::size_t cycles = 0;
+    for (std::size_t start = 0; start < size; ++start) {
+        if (visited[start])
+            continue;
+        ++cycles;
+        std::size_t x = start;
+        do {
+            if (std::cmp_greater_equal(perm[x], size) || visited[x])
+                return std::nullopt;
+            visited[x] = true;
+            x = perm[x];
+        } while (x != start);
+    }
+    return (size - cycles) % 2zu == 0zu ? 1 : -1;
+}
+
+// The cycle lengths of a permutation in non-increasing order, fixed points
+// included, e.g. {3, 1} for (ACB)(D).
+std::optional<std::vector<std::uint32_t>> cycle_type(PermutationView perm) {
+    const std::size_t size = perm.size();
+    Permutation visited(size);
+    auto marks = visited.get_span();
+    const auto unvisited = static_cast<Permutation::uint_t>(size);
+    std::ranges::fill(marks, unvisited);
+
+    std::vector<std::uint32_t> lengths{};
+    for (std::size_t start = 0; start < size; ++start) {
+        if (marks[start] != unvisited)
+            continue;
+        auto length_opt = cycle_length(perm, start, marks, unvisited);
+        if (!length_opt)
+            return std::nullopt;
+        for (std::size_t x = start; marks[x] == unvisited; x = perm[x])
+            marks[x] = 0;
+        lengths.push_back(static_cast<std::uint32_t>(*length_opt));
+    }
+    std::ranges::sort(lengths, std::ranges::greater{});
+    return lengths;
+}
+
+// Monte-Carlo statistics of a sample of permutations, e.g. from
+// `sample_uniform_permutations` or `sample_group_elements`: how many of them
+// have which order and how many fixed points.
+struct sample_statistics {
+    std::size_t samples{};
+    // (order, number of samples), sorted by order
+    std::vector<std::pair<std::size_t, std::size_t>> orders{};
+    // number of samples with k fixed points at index k
+    std::vector<std::size_t> fixed_points{};
+};
+
+template <std::unsigned_integral Entry>
+std::optional<sample_statistics>
+get_sample_statistics(const basic_permutation_arena<Entry> &samples) {
+    sample_statistics ret{.samples = samples.size()};
+    ret.fixed_points.assign(samples.places() + 1zu, 0zu);
+    std::map<std::size_t, std::size_t> order_counts{};
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        const auto perm = samples[i];
+        auto order_opt = permutation_order(perm);
+        if (!order_opt)
+            return std::nullopt;
+        order_counts[*order_opt] += 1;
+
+        std::size_t fixed = 0;
+        for (std::size_t x = 0; x < perm.size(); ++x)
+            fixed += perm[x] == x;
+        ret.fixed_points[fixed] += 1;
+    }
+    ret.orders.assign(order_counts.begin(), order_counts.end());
     return ret;
 }
 
+std::optional<sample_statistics>
+get_sample_statistics(const compact_permutation_arena &samples) {
+    return samples.visit(
+        [](const auto &arena) { return get_sample_statistics(arena); });
+}
+
+template <group_config_c gc>
+std::optional<std::size_t> get_order(typename gc::element_view_type view) {
+    if constexpr (std::same_as<gc, symetric_group>) {
+        return permutation_order(view);
+    } else if constexpr (std::same_as<gc, tabulated_group>) {
+        return view.table->element_order(view.id);
+    } else {
+        gc config_obj = static_cast<gc>(view);
+        const typename gc::element_type identity_permutation =
+            get_identity<gc>(config_obj);
+        const typename gc::element_view_type identity = identity_permutation;
+        typename gc::element_type perm = identity_permutation;
+
+        std::size_t ret = 0;
+        do {
+            auto perm_opt = compose_permutations<gc>(view, perm);
+            if (!perm_opt) {
+                return std::nullopt;
+            }
+            perm = std::move(*perm_opt);
+            ret += 1;
+        } while (typename gc::element_view_type{perm} != identity);
+        return ret;
+    }
+}
+
+// For the elements of a finite group, the index of x^k in `elements` for every
+// element x. Returns std::nullopt, if some power is not in `elements`.
+template <concepts::range_of_PermutationView_likes_c R, std::integral Integer>
+std::optional<std::vector<std::uint32_t>> power_map(R &&elements, Integer k) {
+    std::vector<PermutationView> views{};
+    // elements, that are produced on the fly (e.g. by `all`), need a copy
+    std::vector<Permutation> owned{};
+    using reference_t = std::ranges::range_reference_t<R>;
+    if constexpr (std::is_lvalue_reference_v<reference_t>) {
+        for (const auto &e : elements)
+            views.push_back(PermutationView{e});
+    } else {
+        for (auto &&e : elements)
+            owned.push_back(Permutation{PermutationView{e}});
+        for (const auto &e : owned)
+            views.push_back(PermutationView{e});
+    }
+    if (views.empty())
+        return std::vector<std::uint32_t>{};
+
+    // (fingerprint, index) sorted, so a lookup compares 64 bit integers and
+    // only the entries of the matches
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> sorted(views.size());
+    for (std::size_t i = 0; i < views.size(); ++i)
+        sorted[i] = {permutation_fingerprint(views[i]),
+                     static_cast<std::uint32_t>(i)};
+    std::ranges::sort(sorted);
+
+    std::vector<std::uint32_t> map(views.size());
+    Permutation buffer(views.front().size());
+    for (std::size_t i = 0; i < views.size(); ++i) {
+        if (!power_into(buffer.get_span(), views[i], k))
+            return std::nullopt;
+        const PermutationView x_to_the_k = buffer;
+        const std::uint64_t fingerprint = permutation_fingerprint(x_to_the_k);
+        auto it = std::ranges::lower_bound(
+            sorted, fingerprint, {},
+            &std::pair<std::uint64_t, std::uint32_t>::first);
+        while (it != sorted.end() && it->first == fingerprint &&
+               !(views[it->second] == x_to_the_k))
+            ++it;
+        if (it == sorted.end() || it->first != fingerprint)
+            return std::nullopt;
+        map[i] = it->second;
+    }
+    return map;
+}
+
 static void print_all_powers(std::FILE *stream,
                              Permutation::readonly_span view) {
-    const Permutation identity_permutation =
-        get_identity<symetric_group>(
-            symetric_group{.places = view.size()});
-    const PermutationView identity = identity_permutation;
-    auto perm = identity_permutation;
+    auto order_opt = permutation_order(view);
+    if (!order_opt) {
+        std::println(stderr, "error");
+        std::println(stream, ".");
+        return;
+    }
 
-    do {
-        auto perm_opt = compose_permutations<symetric_group>(view, perm);
-        if (!perm_opt) {
+    Permutation perm(view.size());
+    for (std::size_t k = 1; k <= *order_opt; ++k) {
+        if (!power_into(perm.get_span(), view, k)) {
             std::println(stderr, "error");
             break;
         }
-        perm = std::move(*perm_opt);
         std::print(stream, "{:ab}", perm);
-        if (perm == identity)
+        if (k == *order_opt)
             break;
         std::print(stream, ",  ");
-    } while (true);
+    }
     std::println(stream, ".");
 }
 
@@ -599,6 +1191,127 @@ calc_permutation(std::function<ReturnTypeOfCallBack(PermutationView)> call_back,
     return static_cast<ReturnTypeOfCallBack>(true);
 }
 
+// Restrictions for `calc_constrained_permutation`. Instead of filtering all
+// n! permutations afterwards, the search never enters a branch, whose prefix
+// is already ruled out.
+struct permutation_constraints {
+    // one bit per value in the masks
+    static constexpr std::size_t max_places = 64zu;
+
+    // bit v of allowed[i] is set, if position i may have the value v
+    std::vector<std::uint64_t> allowed{};
+    // Called with every prefix of a candidate, i.e. with its first k
+    // entries for k = 1 .. n, the last one being the complete permutation.
+    // Returning false prunes all permutations with this prefix.
+    std::function<bool(PermutationView)> prefix_predicate{};
+
+    // no restrictions, i.e. all of S_`places`
+    static permutation_constraints none(std::size_t places) {
+        if (places > max_places)
+            throw PermutationException();
+        const std::uint64_t all_values =
+            places == max_places ? ~std::uint64_t{0}
+                                 : (std::uint64_t{1} << places) - 1u;
+        return permutation_constraints{
+            .allowed = std::vector<std::uint64_t>(places, all_values)};
+    }
+    // the permutations without fixed points
+    static permutation_constraints derangements(std::size_t places) {
+        auto ret = none(places);
+        for (std::size_t i = 0; i < places; ++i)
+            ret.forbid(i, i);
+        return ret;
+    }
+
+    std::size_t places() const { return allowed.size(); }
+
+    permutation_constraints &forbid(std::size_t position, std::size_t value) {
+        assert(position < places() && value < places());
+        allowed[position] &= ~(std::uint64_t{1} << value);
+        return *this;
+    }
+    // position ↦ value, which no other position may have then
+    permutation_constraints &fix(std::size_t position, std::size_t value) {
+        assert(position < places() && value < places());
+        const std::uint64_t bit = std::uint64_t{1} << value;
+        for (auto &mask : allowed)
+            mask &= ~bit;
+        allowed[position] = bit;
+        return *this;
+    }
+};
+
+// Calls `call_back` with every permutation, that satisfies `constraints`, in
+// lexicographic order, like `calc_permutation` does with all of them. The
+// values of a position are the set bits of its mask, that are not used by
+// the prefix. A prefix is dropped, as soon as the predicate rejects it or a
+// later position has no value left, so the cost depends on the number of
+// admissible prefixes, not on n!.
+template <concepts::bool_or_void_c ReturnTypeOfCallBack>
+[[nodiscard]] static ReturnTypeOfCallBack calc_constrained_permutation(
+    std::function<ReturnTypeOfCallBack(PermutationView)> call_back,
+    const permutation_constraints &constraints) {
+
+    const std::size_t size = constraints.places();
+    if (size > permutation_constraints::max_places)
+        throw PermutationException();
+    const auto &allowed = constraints.allowed;
+    const auto &predicate = constraints.prefix_predicate;
+
+    Permutation perm(static_cast<Permutation::uint_t>(size));
+    auto span = perm.get_span();
+    if (size == 0zu)
+        return call_back(perm);
+
+    // the values, that are still to try at every depth of the search
+    std::array<std::uint64_t, permutation_constraints::max_places>
+        candidates{};
+    std::uint64_t unused = size == permutation_constraints::max_places
+                               ? ~std::uint64_t{0}
+                               : (std::uint64_t{1} << size) - 1u;
+    auto admissible = [&](std::size_t depth) {
+        if (predicate && !predicate(PermutationView{span.first(depth + 1zu)}))
+            return false;
+        for (std::size_t later = depth + 1zu; later < size; ++later)
+            if ((allowed[later] & unused) == 0u)
+                return false;
+        return true;
+    };
+
+    std::size_t depth = 0;
+    candidates[0] = allowed[0] & unused;
+    while (true) {
+        if (candidates[depth] == 0u) {
+            if (depth == 0zu)
+                break;
+            --depth;
+            unused |= std::uint64_t{1} << span[depth];
+            continue;
+        }
+        const auto value = static_cast<Permutation::uint_t>(
+            std::countr_zero(candidates[depth]));
+        candidates[depth] &= candidates[depth] - 1u;
+        span[depth] = value;
+        unused &= ~(std::uint64_t{1} << value);
+
+        const bool ok = admissible(depth);
+        if (ok && depth + 1zu < size) {
+            ++depth;
+            candidates[depth] = allowed[depth] & unused;
+            continue;
+        }
+        if (ok) {
+            if constexpr (std::is_same_v<ReturnTypeOfCallBack, void>) {
+                call_back(perm);
+            } else if (!call_back(perm)) {
+                return false;
+            }
+        }
+        unused |= std::uint64_t{1} << value;
+    }
+    return static_cast<ReturnTypeOfCallBack>(true);
+}
+
 template <std::size_t places> [[nodiscard]] bool print_permutation() {
     const auto max_number_of_digits = 'Z' - 'A' + 1zu;
     if (std::cmp_greater(places, max_number_of_digits)) {
@@ -613,6 +1326,8 @@ template <std::size_t places> [[nodiscard]] bool print_permutation() {
         print_all_powers(stdout, perm);
     };
 
+    // the powers are printed during the enumeration
+    PERMUTATIONS_TRACE_SCOPE("enumerate and print powers");
     calc_permutation<void>(print, all, all.first(0), all);
     return true;
 }
@@ -625,83 +1340,667 @@ template <std::integral Integer> Integer fakultät(const Integer numb) {
     return result;
 }
 
-template <group_config_c group_config_t,
-          range_of_element_view_likes_c<group_config_t> R>
-[[nodiscard]] static bool print_table(R perms, group_config_t group_config) {
+// Lexicographic rank of a permutation in S_n, i.e. its index in the sequence
+// produced by `calc_permutation` and `all`.
+std::optional<std::uint64_t> rank_permutation(PermutationView view) {
+    static constexpr std::size_t max_places = 20zu; // 20! < 2^64
+    const std::size_t size = view.size();
+    if (size > max_places)
+        return std::nullopt;
+
+    std::bitset<max_places> used{};
+    std::uint64_t rank = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto value = view[i];
+        if (std::cmp_greater_equal(value, size) || used.test(value))
+            return std::nullopt;
+        // number of smaller values, that are still available
+        std::uint64_t smaller = 0;
+        for (std::size_t v = 0; v < value; ++v)
+            smaller += !used.test(v);
+        used.set(value);
+        rank = rank * (size - i) + smaller;
+    }
+    return rank;
+}
+
+// Which permutations `all_permutations_view` enumerates.
+enum class permutation_parity { any, even, odd };
+
+// Lazy random access view over all n! permutations of S_n in lexicographic
+// order. The elements are computed on demand by unranking, so seeking with
+// `std::views::drop`, `std::views::stride` or `operator[]` is O(1) and no
+// permutation is stored except the one being dereferenced.
+//
+// With `permutation_parity::even` or `odd` the view only has the n!/2 even
+// or odd permutations, still in lexicographic order, so A_n costs half of a
+// pass over S_n. The number of inversions of a permutation is the sum of the
+// digits of its rank in the factorial number system. The ranks 2k and 2k + 1
+// only differ in the last digit, so exactly one of them has the parity.
+class all_permutations_view
+    : public std::ranges::view_interface<all_permutations_view> {
+  public:
+    static constexpr std::uint32_t max_places = 20u; // 20! < 2^63
+
+    class iterator {
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Permutation;
+        using difference_type = std::int64_t;
+
+      private:
+        std::uint32_t m_places{};
+        permutation_parity m_parity{};
+        difference_type m_index{};
+
+        // the rank in S_n
+        std::uint64_t rank() const {
+            const auto index = static_cast<std::uint64_t>(m_index);
+            if (m_parity == permutation_parity::any)
+                return index;
+            std::uint64_t rest = 2u * index;
+            std::uint64_t inversions = 0;
+            std::uint64_t radix = fakultät(std::uint64_t{m_places});
+            for (std::uint32_t i = 0; i < m_places; ++i) {
+                radix /= (m_places - i);
+                inversions += rest / radix;
+                rest %= radix;
+            }
+            const std::uint64_t odd = m_parity == permutation_parity::odd;
+            return 2u * index + ((inversions % 2u) ^ odd);
+        }
+
+      public:
+        constexpr iterator() = default;
+        constexpr iterator(std::uint32_t places, difference_type index,
+                           permutation_parity parity = permutation_parity::any)
+            : m_places{places}, m_parity{parity}, m_index{index} {}
+
+        Permutation operator*() const {
+            // digits of `m_index` in the factorial number system
+            Permutation::uint_t available[max_places]{};
+            for (Permutation::uint_t i = 0; i < m_places; ++i)
+                available[i] = i;
+
+            Permutation perm(m_places);
+            auto span = perm.get_span();
+            auto rest = rank();
+            std::uint64_t radix = fakultät(std::uint64_t{m_places});
+            for (std::uint32_t i = 0; i < m_places; ++i) {
+                radix /= (m_places - i);
+                const auto digit = rest / radix;
+                rest %= radix;
+                span[i] = available[digit];
+                std::shift_left(available + digit, available + m_places - i,
+                                1);
+            }
+            return perm;
+        }
+        Permutation operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        constexpr difference_type index() const { return m_index; }
+
+        constexpr iterator &operator++() {
+            ++m_index;
+            return *this;
+        }
+        constexpr iterator operator++(int) {
+            auto copy = *this;
+            ++m_index;
+            return copy;
+        }
+        constexpr iterator &operator--() {
+            --m_index;
+            return *this;
+        }
+        constexpr iterator operator--(int) {
+            auto copy = *this;
+            --m_index;
+            return copy;
+        }
+        constexpr iterator &operator+=(difference_type n) {
+            m_index += n;
+            return *this;
+        }
+        constexpr iterator &operator-=(difference_type n) {
+            m_index -= n;
+            return *this;
+        }
+        friend constexpr iterator operator+(iterator it, difference_type n) {
+            return it += n;
+        }
+        friend constexpr iterator operator+(difference_type n, iterator it) {
+            return it += n;
+        }
+        friend constexpr iterator operator-(iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend constexpr difference_type operator-(const iterator &a,
+                                                   const iterator &b) {
+            return a.m_index - b.m_index;
+        }
+        friend constexpr bool operator==(const iterator &a,
+                                         const iterator &b) {
+            return a.m_index == b.m_index;
+        }
+        friend constexpr auto operator<=>(const iterator &a,
+                                          const iterator &b) {
+            return a.m_index <=> b.m_index;
+        }
+    };
+
+  private:
+    std::uint32_t m_places{};
+    permutation_parity m_parity{};
+
+  public:
+    constexpr all_permutations_view() = default;
+    constexpr explicit all_permutations_view(
+        std::uint32_t places,
+        permutation_parity parity = permutation_parity::any)
+        : m_places{places}, m_parity{parity} {
+        if (places > max_places)
+            throw PermutationException();
+    }
+
+    constexpr iterator begin() const {
+        return iterator{m_places, 0, m_parity};
+    }
+    iterator end() const {
+        return iterator{m_places,
+                        static_cast<iterator::difference_type>(size()),
+                        m_parity};
+    }
+    std::size_t size() const {
+        const std::size_t n_factorial = fakultät(std::size_t{m_places});
+        switch (m_parity) {
+        case permutation_parity::any:
+            return n_factorial;
+        case permutation_parity::even:
+            // the identity of S_0 and S_1 is even
+            return m_places < 2u ? 1zu : n_factorial / 2zu;
+        case permutation_parity::odd:
+            return m_places < 2u ? 0zu : n_factorial / 2zu;
+        }
+        std::unreachable();
+    }
+};
+static_assert(std::ranges::random_access_range<all_permutations_view>);
+static_assert(std::ranges::sized_range<all_permutations_view>);
+static_assert(std::ranges::view<all_permutations_view>);
+
+inline all_permutations_view all(std::uint32_t places) {
+    return all_permutations_view{places};
+}
+
+// The elements of the alternating group A_n.
+inline all_permutations_view even_permutations(std::uint32_t places) {
+    return all_permutations_view{places, permutation_parity::even};
+}
+
+// The odd permutations of S_n, the other coset of A_n.
+inline all_permutations_view odd_permutations(std::uint32_t places) {
+    return all_permutations_view{places, permutation_parity::odd};
+}
+
+} // namespace permutations
+
+template <>
+inline constexpr bool
+    std::ranges::enable_borrowed_range<permutations::all_permutations_view> =
+        true;
+
+namespace permutations {
+
+// Everything a cell of a group table shows of its element.
+struct element_attributes {
+    std::string name;                 // `to_string()`, for row_/column_
+    std::string label;                // `std::format("{}", ...)`
+    std::string other_representation; // the text of the cell
+    std::size_t order{};
+    std::string order_text; // `order` for the class and title
+};
+
+// The attributes of a set of elements, computed once per element instead of
+// once per cell. The entries are sorted by the compare type of the group, an
+// element's index is its position among them.
+template <group_config_c group_config_t> class element_attribute_cache {
+    using elm_t = group_config_t::element_type;
     using view_t = group_config_t::element_view_type;
+    using cmp_t = group_config_t::compare_type;
+
+  public:
+    struct entry {
+        elm_t element;
+        element_attributes attributes;
+    };
+
+  private:
+    std::vector<entry> m_entries{};
 
-    auto print_cell = [](view_t perm, std::string_view row,
-                         std::string_view column) -> bool {
-        bool is_header = row == "header" || column == "header";
-        std::string perm_str = std::format("{}", perm);
-        const auto &hover_text = perm_str;
+  public:
+    [[nodiscard]] static std::optional<element_attributes>
+    compute(view_t perm) {
         auto display_text_opt = get_other_representation<group_config_t>(perm);
         if (!display_text_opt) {
             std::println(stderr, "this is the fucked up thing: {}", perm);
-            return false;
+            return std::nullopt;
         }
         auto order_opt = get_order<group_config_t>(perm);
         if (!order_opt) {
-            return false;
+            return std::nullopt;
         }
-        static constexpr const char format[] =
-            "<t{5} "
-            R"~(class="{1}{2} row_{6} column_{7} order_{4}" )~"
-            R"~(data-row="{6}" data-column="{7}" data-perm="{1}" )~"
-            R"~(title="{3}, order: {4}">)~"
-            "{8}{0}"
-            "</t{5}>";
-        std::print(format, *display_text_opt, perm_str,
-                   (is_header ? " table_header" : ""), hover_text, *order_opt,
-                   (is_header ? 'h' : 'd'), row, column,
-                   (is_header && false ? R"(<input type="checkbox" />)" : ""));
-        return true;
-    };
+        return element_attributes{
+            .name = perm.to_string(),
+            .label = std::format("{}", perm),
+            .other_representation = std::move(*display_text_opt),
+            .order = *order_opt,
+            .order_text = std::to_string(*order_opt),
+        };
+    }
+
+    // Duplicates in `elements` share one entry.
+    template <typename R>
+    [[nodiscard]] static std::optional<element_attribute_cache>
+    create(R &&elements) {
+        std::vector<elm_t> sorted{};
+        for (const auto &e : elements)
+            sorted.push_back(elm_t(e));
+        std::ranges::sort(sorted, cmp_t{});
+        const auto duplicates = std::ranges::unique(
+            sorted, [](const elm_t &a, const elm_t &b) {
+                return !cmp_t{}(a, b);
+            });
+        sorted.erase(duplicates.begin(), duplicates.end());
+
+        element_attribute_cache cache{};
+        cache.m_entries.reserve(sorted.size());
+        for (elm_t &e : sorted) {
+            auto attributes = compute(view_t{e});
+            if (!attributes)
+                return std::nullopt;
+            cache.m_entries.push_back(
+                entry{.element = std::move(e),
+                      .attributes = std::move(*attributes)});
+        }
+        return cache;
+    }
+
+    std::size_t size() const { return m_entries.size(); }
+    const entry &operator[](std::size_t index) const {
+        return m_entries[index];
+    }
+
+    // nullptr, if `x` is not in the cache
+    const entry *find(const elm_t &x) const {
+        auto it = std::ranges::lower_bound(m_entries, x, cmp_t{},
+                                           &entry::element);
+        if (it == m_entries.end() || cmp_t{}(x, it->element))
+            return nullptr;
+        return &*it;
+    }
+
+    // The entries of `elements` in their order, or std::nullopt, if one of
+    // them is missing.
+    template <typename R>
+    std::optional<std::vector<const entry *>> lookup(R &&elements) const {
+        std::vector<const entry *> ret{};
+        for (const auto &e : elements) {
+            const entry *found = find(elm_t(e));
+            if (!found)
+                return std::nullopt;
+            ret.push_back(found);
+        }
+        return ret;
+    }
+};
+
+// Appends one cell of a group table to `out`. `row` and `column` are the
+// names of the row and column element, or "header" for header cells.
+static void render_table_cell(std::string &out, const element_attributes &perm,
+                              std::string_view row, std::string_view column) {
+    const bool is_header = row == "header" || column == "header";
+    const char tag = is_header ? 'h' : 'd';
+    out += "<t";
+    out += tag;
+    out += R"( class=")";
+    out += perm.label;
+    if (is_header)
+        out += " table_header";
+    out += " row_";
+    out += row;
+    out += " column_";
+    out += column;
+    out += " order_";
+    out += perm.order_text;
+    out += R"(" data-row=")";
+    out += row;
+    out += R"(" data-column=")";
+    out += column;
+    out += R"(" data-perm=")";
+    out += perm.label;
+    out += R"(" title=")";
+    out += perm.label;
+    out += ", order: ";
+    out += perm.order_text;
+    out += R"(">)";
+    out += perm.other_representation;
+    out += "</t";
+    out += tag;
+    out += '>';
+}
 
-    auto print_row = [&](view_t perm_row,
-                         bool is_header_row = false) -> bool {
-        for (view_t perm_column : perms) {
-            auto opt =
-                compose_permutations<group_config_t>(perm_row, perm_column);
-            std::string perm_column_str = perm_column.to_string();
-            std::string perm_row_str = perm_row.to_string();
-            if (!opt || !print_cell(*opt,
-                                    (is_header_row ? std::string_view{"header"}
-                                                   : perm_row_str),
-                                    perm_column_str)) {
+// Appends the cells `perm_row` ∘ c for every c in `columns` and the end of
+// the row to `out`. `row` is the name of `perm_row` or "header". Products,
+// that are not in `cache`, get their attributes computed on the spot.
+template <group_config_c group_config_t>
+[[nodiscard]] static bool render_table_row(
+    std::string &out, const element_attribute_cache<group_config_t> &cache,
+    typename group_config_t::element_view_type perm_row, std::string_view row,
+    std::span<const typename element_attribute_cache<group_config_t>::entry
+                  *const>
+        columns) {
+    using view_t = group_config_t::element_view_type;
+    for (const auto *column : columns) {
+        auto opt = compose_permutations<group_config_t>(
+            perm_row, view_t{column->element});
+        if (!opt)
+            return false;
+        if (const auto *product = cache.find(*opt)) {
+            render_table_cell(out, product->attributes, row,
+                              column->attributes.name);
+        } else {
+            auto attributes =
+                element_attribute_cache<group_config_t>::compute(*opt);
+            if (!attributes)
                 return false;
+            render_table_cell(out, *attributes, row, column->attributes.name);
+        }
+    }
+    out += "</tr>\n";
+    return true;
+}
+
+// Renders `number_of_rows` rows with `render(buffer, row)` on
+// `number_of_threads` threads and hands them to `emit` in order, from the
+// calling thread. At most `rows_in_flight` rendered rows wait for their turn,
+// so memory stays flat no matter how many rows there are; their buffers are
+// reused.
+template <typename Render, typename Emit>
+[[nodiscard]] static bool
+render_rows_in_order(std::size_t number_of_rows, std::size_t number_of_threads,
+                     std::size_t rows_in_flight, Render &&render, Emit &&emit) {
+    struct slot {
+        std::string text{};
+        bool ready = false;
+        bool ok = true;
+    };
+    rows_in_flight = std::max(rows_in_flight, 1zu);
+    std::vector<slot> slots(rows_in_flight);
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::size_t next_row = 0; // next row to be rendered
+    std::size_t emitted = 0;  // rows handed to `emit`
+    bool abort = false;
+
+    auto worker = [&] {
+        while (true) {
+            std::size_t row;
+            std::string text;
+            {
+                std::unique_lock lock(mutex);
+                changed.wait(lock, [&] {
+                    return abort || next_row >= number_of_rows ||
+                           next_row < emitted + rows_in_flight;
+                });
+                if (abort || next_row >= number_of_rows)
+                    return;
+                row = next_row++;
+                text = std::move(slots[row % rows_in_flight].text);
+            }
+            text.clear();
+            const bool ok = render(text, row);
+            {
+                std::lock_guard lock(mutex);
+                slot &s = slots[row % rows_in_flight];
+                s.text = std::move(text);
+                s.ok = ok;
+                s.ready = true;
             }
+            changed.notify_all();
         }
-        std::println("</tr>");
-        return true;
     };
 
+    bool ok = true;
+    {
+        std::vector<std::jthread> threads{};
+        for (std::size_t t = 0; t < std::max(number_of_threads, 1zu); ++t)
+            threads.emplace_back(worker);
+
+        for (std::size_t row = 0; row < number_of_rows; ++row) {
+            slot &s = slots[row % rows_in_flight];
+            {
+                std::unique_lock lock(mutex);
+                changed.wait(lock, [&] { return s.ready; });
+                s.ready = false;
+            }
+            // the slot is not touched by the workers until `emitted` moves on
+            if (!s.ok) {
+                ok = false;
+            } else {
+                emit(std::string_view{s.text});
+            }
+            {
+                std::lock_guard lock(mutex);
+                emitted += 1;
+                abort = !ok;
+            }
+            changed.notify_all();
+            if (!ok)
+                break;
+        }
+    }
+    return ok;
+}
+
+// With `number_of_threads` > 1, the rows of the table body are rendered
+// concurrently by `render_rows_in_order`. The output is the same.
+template <group_config_c group_config_t,
+          range_of_element_view_likes_c<group_config_t> R>
+[[nodiscard]] static bool print_table(R perms, group_config_t group_config,
+                                      std::size_t number_of_threads = 1zu) {
+    PERMUTATIONS_TRACE_SCOPE("render table");
+    auto cache = element_attribute_cache<group_config_t>::create(perms);
+    if (!cache)
+        return false;
+    const auto entries_opt = cache->lookup(perms);
+    if (!entries_opt)
+        return false;
+    const auto &entries = *entries_opt;
+
+    std::string buffer{};
     std::println("<table>");
     // print header of table
     std::print("<thead>\n<tr><th></th>");
     const auto identity = get_identity(group_config);
-    if (!print_row(identity, true))
+    if (!render_table_row<group_config_t>(buffer, *cache, identity, "header",
+                                          entries))
         return false;
+    std::print("{}", buffer);
     std::println("</thead>");
 
     // print bulk of the table
     std::println("<tbody>");
-    for (view_t perm_row : perms) {
-        std::print("<tr>");
-        print_cell(perm_row, perm_row.to_string(), "header");
-        if (!print_row(perm_row))
+    auto render = [&](std::string &out, std::size_t row) -> bool {
+        const auto &perm_row = *entries[row];
+        out += "<tr>";
+        render_table_cell(out, perm_row.attributes, perm_row.attributes.name,
+                          "header");
+        return render_table_row<group_config_t>(
+            out, *cache, perm_row.element, perm_row.attributes.name, entries);
+    };
+    if (number_of_threads <= 1zu) {
+        for (std::size_t row = 0; row < entries.size(); ++row) {
+            buffer.clear();
+            if (!render(buffer, row))
+                return false;
+            std::print("{}", buffer);
+        }
+    } else {
+        auto emit = [](std::string_view row) { std::print("{}", row); };
+        if (!render_rows_in_order(entries.size(), number_of_threads,
+                                  4zu * number_of_threads, render, emit))
             return false;
     }
     std::println("</tbody></table>");
     return true;
 }
 
-template <concepts::range_of_PermutationView_likes_c R,
-          concepts::uint32_c UInt32>
-[[nodiscard]] static bool print_css(R perms, UInt32 places,
-                                    std::size_t number_of_permutations) {
+// Large tables are too much for one HTML page. This writes the table in blocks
+// of `tile_size` × `tile_size` cells to `<directory>/tile_<row>_<column>.html`,
+// each of them with its own row and column headers. The tiles are rendered by
+// `number_of_threads` threads. `<directory>/index.html` only contains
+// placeholders, from which `script.js` loads the tiles, when they scroll into
+// view. Because the tiles are fetched, the directory has to be served over
+// HTTP, and `script.js` and `style.css` have to be copied next to it.
+template <group_config_c group_config_t,
+          range_of_element_view_likes_c<group_config_t> R>
+[[nodiscard]] static bool print_table_tiled(
+    R &&perms, group_config_t group_config,
+    const std::filesystem::path &directory, std::size_t tile_size,
+    std::size_t number_of_threads = std::thread::hardware_concurrency()) {
+    auto cache = element_attribute_cache<group_config_t>::create(perms);
+    if (!cache)
+        return false;
+    const auto entries_opt = cache->lookup(perms);
+    if (!entries_opt)
+        return false;
+    const auto &entries = *entries_opt;
+    const std::size_t n = entries.size();
+    if (tile_size == 0zu || n == 0zu)
+        return false;
+    const std::size_t tiles_per_side = (n + tile_size - 1zu) / tile_size;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec)
+        return false;
+
+    auto write_file = [](const std::filesystem::path &path,
+                         std::string_view content) -> bool {
+        std::FILE *file = std::fopen(path.string().c_str(), "wb");
+        if (!file)
+            return false;
+        const bool ok =
+            std::fwrite(content.data(), 1, content.size(), file) ==
+            content.size();
+        return std::fclose(file) == 0 && ok;
+    };
+    auto tile_name = [](std::size_t row, std::size_t column) {
+        return std::format("tile_{}_{}.html", row, column);
+    };
+
+    auto render_tile = [&](std::string &out, std::size_t tile_row,
+                           std::size_t tile_column) -> bool {
+        const auto block = [&](std::size_t tile) {
+            const std::size_t first = tile * tile_size;
+            return std::span{entries}.subspan(
+                first, std::min(tile_size, n - first));
+        };
+        const auto rows = block(tile_row);
+        const auto columns = block(tile_column);
+
+        out.assign("<table>\n<thead>\n<tr><th></th>");
+        const auto identity = get_identity(group_config);
+        if (!render_table_row<group_config_t>(out, *cache, identity, "header",
+                                              columns))
+            return false;
+        out += "</thead>\n<tbody>\n";
+        for (const auto *perm_row : rows) {
+            out += "<tr>";
+            render_table_cell(out, perm_row->attributes,
+                              perm_row->attributes.name, "header");
+            if (!render_table_row<group_config_t>(out, *cache,
+                                                  perm_row->element,
+                                                  perm_row->attributes.name,
+                                                  columns))
+                return false;
+        }
+        out += "</tbody></table>\n";
+        return true;
+    };
+
+    // the tiles are handed out to the threads one after another
+    const std::size_t number_of_tiles = tiles_per_side * tiles_per_side;
+    std::atomic<std::size_t> next_tile{0};
+    std::atomic<bool> error{false};
+    {
+        std::vector<std::jthread> threads{};
+        for (std::size_t t = 0; t < std::max(number_of_threads, 1zu); ++t) {
+            threads.emplace_back([&] {
+                std::string tile{};
+                for (std::size_t i = next_tile++; i < number_of_tiles;
+                     i = next_tile++) {
+                    const std::size_t row = i / tiles_per_side;
+                    const std::size_t column = i % tiles_per_side;
+                    if (!render_tile(tile, row, column) ||
+                        !write_file(directory / tile_name(row, column), tile))
+                        error = true;
+                }
+            });
+        }
+    }
+    if (error)
+        return false;
+
+    std::size_t max_order = 1;
+    for (std::size_t i = 0; i < cache->size(); ++i)
+        max_order = std::max(max_order, (*cache)[i].attributes.order);
+
+    std::string index{};
+    auto out = std::back_inserter(index);
+    std::format_to(out, "<!DOCTYPE html>\n<html>\n<head>\n"
+                        R"(<script src="./script.js" defer></script>)"
+                        "\n<style>\n");
+    for (std::size_t order = 1; order <= max_order; ++order) {
+        std::format_to(out,
+                       "th.order_{0}:not(.selected_elm),\n"
+                       "td.order_{0}:not(.crossed_cell) {{\n"
+                       "    background-color: hsl( {1}deg 75% 75% );\n"
+                       "}}\n",
+                       order, 360zu * (order - 1zu) / max_order);
+    }
+    std::format_to(out,
+                   "</style>\n"
+                   R"(<link rel="stylesheet" href="./style.css" />)"
+                   "\n</head>\n<body>\n"
+                   "<p>number of elements: {0}, tiles: {1} × {1}</p>\n"
+                   R"(<div class="tiles" style="--tiles-per-side: {1};">)"
+                   "\n",
+                   n, tiles_per_side);
+    for (std::size_t row = 0; row < tiles_per_side; ++row) {
+        for (std::size_t column = 0; column < tiles_per_side; ++column) {
+            std::format_to(out, R"(<div class="tile" data-src="{}"></div>)"
+                                "\n",
+                           tile_name(row, column));
+        }
+    }
+    index += "</div>\n</body>\n</html>\n";
+    return write_file(directory / "index.html", index);
+}
+
+// `histogram` is the `order_histogram` of the group, every order that occurs
+// gets its own colour.
+template <concepts::range_of_PermutationView_likes_c R>
+[[nodiscard]] static bool
+print_css(R perms, std::span<const order_histogram_entry> histogram) {
+    PERMUTATIONS_TRACE_SCOPE("render css");
     std::println("<style>");
     if constexpr (false) {
+        const std::size_t number_of_permutations = std::ranges::size(perms);
         size_t color = 0;
         bool first = true;
         for (PermutationView perm : perms) {
@@ -719,9 +2018,9 @@ template <concepts::range_of_PermutationView_likes_c R,
             color += (360zu / number_of_permutations);
         }
     } else {
-        for (size_t order : std::views::iota(1zu) | std::views::take(places)) {
-            std::size_t color_by_order =
-                360zu * (order - 1zu) / static_cast<size_t>(places);
+        for (std::size_t i = 0; i < histogram.size(); ++i) {
+            const std::uint64_t order = histogram[i].order;
+            std::size_t color_by_order = 360zu * i / histogram.size();
             std::println("th.order_{0}:not(.selected_elm),\n"
                          "td.order_{0}:not(.crossed_cell) {{\n"
                          "    background-color: hsl( {1}deg 75% 75% );\n"
@@ -759,6 +2058,9 @@ template <std::ranges::range R, concepts::uint32_c UInt32>
         return true;
     };
 
+    // The enumeration calls `print_table` for every permutation, so this
+    // scope is both; the rendering has its own nested "render table" scopes.
+    PERMUTATIONS_TRACE_SCOPE("permuted tables");
     return calc_permutation<bool>(permute_table_and_print, perm, all.first(0),
                                   all);
 }
@@ -778,35 +2080,46 @@ bool compare_by_order(typename gc::element_view_type a,
         return false;
 }
 
+// Prints the table of S_`places`, or with `alternating_group` the table of
+// A_`places`, i.e. of the even permutations only.
 [[nodiscard]] bool print_group_table(std::uint32_t places,
                                      bool permute_table = false,
-                                     bool print_html_end = true) {
-    const auto max_number_of_digits = 'Z' - 'A' + 1zu;
-    if (std::cmp_greater(places, max_number_of_digits)) {
+                                     bool print_html_end = true,
+                                     bool alternating_group = false) {
+    if (std::cmp_greater(places, all_permutations_view::max_places)) {
         return false;
     }
-    Permutation str(places);
-    auto all = str.get_span();
     const symetric_group group_config{.places = places};
 
-    std::size_t number_of_permutations = fakultät(static_cast<size_t>(places));
+    // the numbers come from the cycle types, not from the elements
+    const auto histogram = alternating_group
+                               ? alternating_order_histogram(places)
+                               : order_histogram(places);
+    if (!histogram)
+        return false;
+    big_uint number_of_permutations = big_factorial(places);
+    if (alternating_group && places >= 2u) {
+        [[maybe_unused]] const auto remainder =
+            number_of_permutations.divide(2u);
+        assert(remainder == 0u);
+    }
 
     std::vector<Permutation> perms{};
-    perms.reserve(number_of_permutations);
-
-    auto put_into_vector = [&](PermutationView perm) -> void {
-        perms.push_back(Permutation{perm});
-    };
-
-    calc_permutation<void>(put_into_vector, str, all.first(0), all);
+    {
+        PERMUTATIONS_TRACE_SCOPE("enumerate");
+        perms = all_permutations_view{places, alternating_group
+                                                  ? permutation_parity::even
+                                                  : permutation_parity::any} |
+                std::ranges::to<std::vector>();
+    }
 
-    assert(number_of_permutations == perms.size());
+    assert(number_of_permutations == big_uint{perms.size()});
 
     std::println("<!DOCTYPE html>\n<html>\n<head>");
 
     std::println(R"(<script src="./script.js" defer></script>)");
 
-    if (!print_css(perms, places, number_of_permutations))
+    if (!print_css(perms, *histogram))
         return false;
     std::println("</head>\n<body>");
     std::println("<p>number of permutations: {}</p>", number_of_permutations);
@@ -822,8 +2135,14 @@ bool compare_by_order(typename gc::element_view_type a,
                         });
         auto vector_of_PermutationViews =
             range_of_PermutationViews | std::ranges::to<std::vector>();
-        std::ranges::sort(vector_of_PermutationViews, compare_by_order<symetric_group>);
-        if (!print_table<symetric_group>(vector_of_PermutationViews, group_config))
+        {
+            PERMUTATIONS_TRACE_SCOPE("sort by order");
+            std::ranges::sort(vector_of_PermutationViews,
+                              compare_by_order<symetric_group>);
+        }
+        if (!print_table<symetric_group>(vector_of_PermutationViews,
+                                         group_config,
+                                         std::thread::hardware_concurrency()))
             return false;
         //std::println("<br/><p>unsorted:</p>");
         //if (!print_table<symetric_group>(range_of_PermutationViews, group_config))
@@ -836,9 +2155,134 @@ bool compare_by_order(typename gc::element_view_type a,
     return true;
 }
 
+// Writes the table of S_`places`, sorted by order like `print_group_table`,
+// as tiles to `directory`, see `print_table_tiled`.
+[[nodiscard]] bool write_tiled_group_table(
+    std::uint32_t places, const std::filesystem::path &directory,
+    std::size_t tile_size) {
+    if (std::cmp_greater(places, all_permutations_view::max_places))
+        return false;
+    std::vector<Permutation> perms{};
+    {
+        PERMUTATIONS_TRACE_SCOPE("enumerate");
+        perms = all_permutations_view{places, permutation_parity::any} |
+                std::ranges::to<std::vector>();
+    }
+    std::vector<PermutationView> views(perms.begin(), perms.end());
+    {
+        PERMUTATIONS_TRACE_SCOPE("sort by order");
+        std::ranges::sort(views, compare_by_order<symetric_group>);
+    }
+    return print_table_tiled<symetric_group>(views, {.places = places},
+                                             directory, tile_size);
+}
+
+// The cycle types of `elements`, in the order of the set, i.e. by the ids of
+// their tabulation.
+std::optional<std::vector<std::vector<std::uint32_t>>>
+cycle_types_of(const group_set<symetric_group> &elements) {
+    std::vector<std::vector<std::uint32_t>> cycle_types{};
+    cycle_types.reserve(elements.size());
+    for (const auto &perm : elements) {
+        auto type = cycle_type(perm);
+        if (!type)
+            return std::nullopt;
+        cycle_types.push_back(std::move(*type));
+    }
+    return cycle_types;
+}
+
+// Exports `table`, see `export_table`, into the files
+// `<path_prefix>.elements.csv`, `.table.csv`, `.ndjson` and `.bin`.
+[[nodiscard]] bool
+export_table_files(const tabulation &table,
+                   std::span<const std::vector<std::uint32_t>> cycle_types,
+                   std::string_view path_prefix) {
+    struct file_closer {
+        void operator()(std::FILE *file) const { std::fclose(file); }
+    };
+    using file_ptr = std::unique_ptr<std::FILE, file_closer>;
+    auto open = [&](std::string_view suffix) {
+        const std::string path = std::format("{}{}", path_prefix, suffix);
+        return file_ptr(std::fopen(path.c_str(), "wb"));
+    };
+    file_ptr elements_csv = open(".elements.csv");
+    file_ptr table_csv = open(".table.csv");
+    file_ptr ndjson = open(".ndjson");
+    file_ptr binary = open(".bin");
+    if (!elements_csv || !table_csv || !ndjson || !binary)
+        return false;
+
+    return export_table(table,
+                        table_export_targets{.elements_csv = elements_csv.get(),
+                                             .table_csv = table_csv.get(),
+                                             .ndjson = ndjson.get(),
+                                             .binary = binary.get()},
+                        cycle_types);
+}
+
+// Exports the Cayley table of S_n, see `export_table_files`.
+[[nodiscard]] bool export_symmetric_group_table(std::uint32_t places,
+                                                std::string_view path_prefix) {
+    if (std::cmp_greater(places, all_permutations_view::max_places))
+        return false;
+    group_set<symetric_group> elements{};
+    for (const auto &perm : all(places))
+        elements.insert(perm);
+
+    const symetric_group group_config{.places = places};
+    const auto table = tabulation::create(elements, group_config);
+    if (!table)
+        return false;
+    const auto cycle_types = cycle_types_of(elements);
+    if (!cycle_types)
+        return false;
+    return export_table_files(*table, *cycle_types, path_prefix);
+}
+
+// An element of the closure in `generate_subgroup_from`: its fingerprint and
+// its index in the vector of the elements found so far.
+struct fingerprinted_index {
+    std::uint64_t fingerprint{};
+    std::size_t index{};
+};
+// A product, that is looked up among them.
+struct fingerprinted_view {
+    std::uint64_t fingerprint{};
+    PermutationView perm;
+};
+
+// Orders both by fingerprint first, and only equal fingerprints by the
+// entries. It is no lexicographic order, but most compares are one compare
+// of the fingerprints.
+class fingerprint_less {
+    const std::vector<Permutation> *m_elements{};
+
+    fingerprinted_view view(const fingerprinted_index &x) const {
+        return {x.fingerprint, (*m_elements)[x.index]};
+    }
+    static fingerprinted_view view(const fingerprinted_view &x) { return x; }
+
+  public:
+    using is_transparent = void;
+
+    explicit fingerprint_less(const std::vector<Permutation> &elements)
+        : m_elements{&elements} {}
+
+    template <typename A, typename B>
+    bool operator()(const A &a, const B &b) const {
+        const fingerprinted_view x = view(a);
+        const fingerprinted_view y = view(b);
+        if (x.fingerprint != y.fingerprint)
+            return x.fingerprint < y.fingerprint;
+        return cmp_less(x.perm, y.perm);
+    }
+};
+
 template <group_config_c group_config_t>
 auto generate_subgroup_from(range_of_element_view_likes_c<group_config_t> auto
                                 &&range) -> group_set<group_config_t> {
+    PERMUTATIONS_TRACE_SCOPE("closure");
 
     using cmp_t = typename group_config_t::compare_type;
     using elm_t = typename group_config_t::element_type;
@@ -852,10 +2296,48 @@ auto generate_subgroup_from(range_of_element_view_likes_c<group_config_t> auto
         return less;
     };
 
+    constexpr bool fingerprinted = std::same_as<group_config_t, symetric_group>;
+
+    // Every product is looked up among the elements found so far, `vec`.
+    // Permutations are looked up by their fingerprints, and `seen` only holds
+    // their indices, so they are stored once, in `vec`.
     std::vector<elm_t> vec{};
-    set_t x{};
-    vec.append_range(range);
-    x.insert_range(range);
+    auto seen = [&] {
+        if constexpr (fingerprinted)
+            return std::set<fingerprinted_index, fingerprint_less>(
+                fingerprint_less{vec});
+        else
+            return set_t{};
+    }();
+    // Appends `p` to `vec`, if it is new.
+    auto add = [&](elm_t &&p) {
+        if constexpr (fingerprinted) {
+            const fingerprinted_view key{permutation_fingerprint(p), p};
+            const auto hint = seen.lower_bound(key);
+            if (hint != seen.end() && !seen.key_comp()(key, *hint))
+                return;
+            vec.push_back(std::move(p));
+            seen.emplace_hint(hint, key.fingerprint, vec.size() - 1zu);
+        } else {
+            if (seen.contains(p))
+                return;
+            seen.insert(p);
+            vec.push_back(std::move(p));
+        }
+    };
+
+    {
+        std::vector<elm_t> generators{};
+        generators.append_range(range);
+        if constexpr (std::same_as<group_config_t, symetric_group>) {
+            // checked once here, the products of valid permutations are valid
+            for (const elm_t &e : generators)
+                if (!is_permutation(e))
+                    throw PermutationException();
+        }
+        for (elm_t &e : generators)
+            add(std::move(e));
+    }
 
     for (std::size_t i = 0; i < vec.size(); ++i) {
         elm_t current = vec[i];
@@ -870,47 +2352,37 @@ auto generate_subgroup_from(range_of_element_view_likes_c<group_config_t> auto
             elm_t products[2]{};
             {
                 view_t inner_current = vec[jj];
-                products[0] = std::move(
-                    compose_permutations<group_config_t>(current, inner_current)
-                        .value());
-                products[1] = std::move(
-                    compose_permutations<group_config_t>(inner_current, current)
-                        .value());
+                if constexpr (std::same_as<group_config_t, symetric_group>) {
+                    const auto a = ValidatedPermutationView::assume_valid(
+                        view_t{current});
+                    const auto b =
+                        ValidatedPermutationView::assume_valid(inner_current);
+                    products[0] = compose(a, b).release();
+                    products[1] = compose(b, a).release();
+                } else {
+                    products[0] = std::move(
+                        compose_permutations<group_config_t>(current,
+                                                             inner_current)
+                            .value());
+                    products[1] = std::move(
+                        compose_permutations<group_config_t>(inner_current,
+                                                             current)
+                            .value());
+                }
             }
             //size_t kkk =0;
             for (auto &p : products) {
                 //std::println("{},{}: {}", i, kkk++, p);
-                if (!x.contains(p)) {
-                    //std::println(" - insert");
-                    x.insert(p);
-                    vec.push_back(std::move(p));
-                } else {
-                    //std::println(" - no insert");
-                }
+                add(std::move(p));
             }
         }
         //std::println("");
     }
-    return x;
-}
-
-static void print_binary_permutation(std::span<char> all, std::span<char> rest,
-                                     std::size_t part) {
-    if (rest.empty()) {
-        //if(!all.empty()){
-        print_span(all);
-        //}
-        return;
-    }
-    assert(std::cmp_greater_equal(rest.size(), part));
-    if (std::cmp_greater(part, 0zu)) {
-        rest[0] = 'x';
-        print_binary_permutation(all, rest.subspan(1zu), part - 1zu);
-    }
-    if (std::cmp_greater(rest.size(), part)) {
-        rest[0] = '_';
-        print_binary_permutation(all, rest.subspan(1zu), part);
-    }
+    if constexpr (fingerprinted)
+        return set_t(std::make_move_iterator(vec.begin()),
+                     std::make_move_iterator(vec.end()));
+    else
+        return seen;
 }
 
 [[nodiscard]] bool print_binary_permutation(std::uint32_t places,
@@ -918,50 +2390,14 @@ static void print_binary_permutation(std::span<char> all, std::span<char> rest,
     if (std::cmp_less(places, part)) {
         return false;
     }
-    std::string str(places, '\0');
-    std::span<char> span(str.data(), str.length());
-    print_binary_permutation(span, span, part);
-    return true;
-}
-
-static void print_ternary_permutation(std::span<char> all, std::span<char> rest,
-                                      std::size_t a, std::size_t b,
-                                      std::size_t c) {
-    if (rest.empty()) {
-        print_span(all);
-        return;
-    }
-    assert(std::cmp_equal(rest.size(), a + b + c));
-    if (a > 0zu) {
-        rest[0] = 'a';
-        print_ternary_permutation(all, rest.subspan(1zu), a - 1zu, b, c);
-    }
-    if (b > 0zu) {
-        rest[0] = 'B';
-        print_ternary_permutation(all, rest.subspan(1zu), a, b - 1zu, c);
-    }
-    if (c > 0zu) {
-        rest[0] = ' ';
-        print_ternary_permutation(all, rest.subspan(1zu), a, b, c - 1zu);
-    }
+    const std::uint32_t counts[]{part, places - part};
+    return write_multiset_permutations(stdout, counts, "x_");
 }
 
 [[nodiscard]] bool print_ternary_permutation(std::uint32_t a, std::uint32_t b,
                                              std::uint32_t c) {
-    static_assert(sizeof(std::size_t) >= sizeof(std::uint32_t));
-    auto ab = a + b;
-    if (std::cmp_less(ab, a)) {
-        return false; // overflow
-    }
-    auto abc = ab + c;
-    if (std::cmp_less(abc, ab)) {
-        return false; // overflow
-    }
-    size_t sum = abc;
-    std::string str(abc, '\0');
-    std::span<char> span(str.data(), str.length());
-    print_ternary_permutation(span, span, a, b, c);
-    return true;
+    const std::uint32_t counts[]{a, b, c};
+    return write_multiset_permutations(stdout, counts, "aB ");
 }
 
 void check_expect(PermutationView a, PermutationView b,
@@ -996,16 +2432,62 @@ bool print_bla_group() {
     group_set<group_bla> set =
         generate_subgroup_from<group_bla>(generating_elements);
 
-    std::vector vec = set | std::ranges::to<std::vector>();
-    std::ranges::sort(vec, compare_by_order<group_bla>);
-    return print_table<group_bla>(vec, group_bla{});
+    // The table only needs products, orders and strings of the elements, so
+    // all of them are computed once up front.
+    const auto table = tabulation::create<group_bla>(set);
+    if (!table)
+        return false;
+    std::vector vec = table->elements();
+    {
+        PERMUTATIONS_TRACE_SCOPE("sort by order");
+        std::ranges::sort(vec, compare_by_order<tabulated_group>);
+    }
+    return print_table<tabulated_group>(vec, table->config());
+}
+
+// D_n built as the semidirect product Z_n ⋊ Z_2 from a rotation and a
+// reflection.
+bool print_dihedral_group(std::uint32_t n) {
+    const std::vector<dihedral_group::element_type> generating_elements{
+        dihedral_rotation(n), dihedral_reflection(n)};
+    const dihedral_group group_config = make_dihedral_group(n);
+
+    group_set<dihedral_group> set =
+        generate_subgroup_from<dihedral_group>(generating_elements);
+
+    const auto table = tabulation::create<dihedral_group>(set, group_config);
+    if (!table)
+        return false;
+    std::vector vec = table->elements();
+    {
+        PERMUTATIONS_TRACE_SCOPE("sort by order");
+        std::ranges::sort(vec, compare_by_order<tabulated_group>);
+    }
+    std::println("<p>The dihedral group D<sub>{}</sub> = Z<sub>{}</sub> ⋊ "
+                 "Z<sub>2</sub>:</p>",
+                 n, n);
+    return print_table<tabulated_group>(vec, table->config());
 }
 
 auto get_conjugator(Permutation t) {
     Permutation i = inverse(t);
     return [t = std::move(t), i = std::move(i)](PermutationView v) {
-        PermutationView term[]{i, v, t};
-        return compose_permutations<symetric_group>(term).value();
+        // i ∘ v ∘ t, evaluated point by point, so that the result is the
+        // only allocation
+        const std::size_t size = v.size();
+        if (size != t.size())
+            throw PermutationException();
+        const auto ts = t.get_readonly_span();
+        const auto is = i.get_readonly_span();
+        Permutation result(size);
+        auto span = result.get_span();
+        for (std::size_t x = 0; x < size; ++x) {
+            const auto vx = v[ts[x]];
+            if (std::cmp_greater_equal(vx, size))
+                throw PermutationException();
+            span[x] = is[vx];
+        }
+        return result;
     };
 }
 
@@ -1059,7 +2541,7 @@ bool print_some_sub_groups_of_S4() {
 
     for (size_t i = 1; auto &t : transformers) {
         std::println(stderr, "transformer t{} is: {:ab} {}", i++, t,
-                     (p::PermutationView{t} == identity ? "  (identity)" : ""));
+                     (p::is_identity(t) ? "  (identity)" : ""));
     }
 
     std::println(stderr, "\nLet us transform the group with it:");
@@ -1228,78 +2710,647 @@ bool print_some_sub_groups_of_S4() {
     return !HTML_error;
 }
 
-} // namespace permutations
+// A group of the batch jobs, see `group_cache`.
+struct cached_group {
+    std::uint32_t places{};
+    // the key in the `group_store`
+    std::string key{};
+    group_set<symetric_group> elements{};
+    // the elements, sorted like with `compare_by_order`, and their orders
+    std::vector<Permutation> by_order{};
+    std::vector<std::size_t> orders{};
+    // the orders in the order of `elements`
+    std::vector<std::size_t> element_orders{};
+    // for the exports, only tabulated when it is needed
+    std::unique_ptr<const tabulation> table{};
+    std::vector<std::vector<std::uint32_t>> cycle_types{};
+    // the product table from the `group_store`, if it had one
+    std::vector<std::uint32_t> stored_products{};
+};
 
-int main() {
-    using namespace permutations;
+// The groups of the batch jobs, by their generators, so that all jobs over
+// the same group share one generation. The generators are canonicalized,
+// sorted and without duplicates, so "CAB ACB" and "ACB CAB CAB" are one group.
+// With a `group_store` the groups, their orders and their product tables
+// also outlive the run: groups, that are not in memory, are looked up there
+// first, and new ones are written to it.
+class group_cache {
+    std::map<std::string, cached_group, std::less<>> m_groups{};
+    std::optional<group_store> m_store{};
+    std::size_t m_hits{};
+    std::size_t m_store_hits{};
+    std::size_t m_misses{};
+    std::size_t m_store_errors{};
+
+    // Sorts the elements by their `element_orders`. The same comparisons as
+    // `compare_by_order` give the same order, but every order is computed
+    // once, not in every comparison.
+    static void sort_by_order(cached_group &group) {
+        PERMUTATIONS_TRACE_SCOPE("sort by order");
+        std::vector<std::pair<std::size_t, const Permutation *>> sorted{};
+        sorted.reserve(group.elements.size());
+        for (std::size_t i = 0; const auto &e : group.elements)
+            sorted.emplace_back(group.element_orders[i++], &e);
+        std::ranges::sort(sorted, std::less{},
+                          &std::pair<std::size_t, const Permutation *>::first);
+        for (const auto &[order, e] : sorted) {
+            group.by_order.push_back(*e);
+            group.orders.push_back(order);
+        }
+    }
 
-    check_expect("ABC", "ABC", "ABC");
-    check_expect("ABC", "CAB", "CAB");
-    check_expect("CAB", "ABC", "CAB");
-    check_expect(           str_to_perm_or_throw("CAB"),
-                    inverse(str_to_perm_or_throw("CAB")),
-                            str_to_perm_or_throw("ABC"));
+    std::optional<cached_group> load(std::string_view key,
+                                     std::uint32_t places) {
+        if (!m_store)
+            return std::nullopt;
+        auto stored = m_store->load(key);
+        if (!stored || stored->elements.places() != places ||
+            stored->orders.size() != stored->elements.size())
+            return std::nullopt;
 
-    std::string murks = "BCA";
-    auto opt = str_to_perm(murks);
-    if (!opt)
-        throw std::exception();
-    print_all_powers(stderr, *opt);
+        cached_group group{.places = places, .key = std::string{key}};
+        // stored in the order of the set, so every element goes to the end
+        for (std::size_t i = 0; i < stored->elements.size(); ++i)
+            group.elements.emplace_hint(group.elements.end(),
+                                        stored->elements[i]);
+        if (group.elements.size() != stored->elements.size())
+            return std::nullopt;
+        group.element_orders.assign(stored->orders.begin(),
+                                    stored->orders.end());
+        sort_by_order(group);
+        group.stored_products = std::move(stored->products);
+        return group;
+    }
 
-    bool HTML_error = false;
-    if (!print_group_table(3, false, false)) {
-        std::print(stderr, "error");
-        HTML_error = true;
+    void save(const cached_group &group) {
+        if (!m_store)
+            return;
+        stored_group stored{
+            .elements = permutation_arena(group.places, group.elements.size())};
+        for (std::size_t i = 0; const auto &e : group.elements) {
+            std::ranges::copy(e.get_readonly_span(),
+                              stored.elements.slot(i).begin());
+            ++i;
+        }
+        stored.orders.assign(group.element_orders.begin(),
+                             group.element_orders.end());
+        if (group.table) {
+            const std::uint32_t n = group.table->order();
+            stored.products.reserve(std::size_t{n} * n);
+            for (std::uint32_t a = 0; a < n; ++a)
+                for (std::uint32_t b = 0; b < n; ++b)
+                    stored.products.push_back(group.table->compose(a, b));
+        }
+        if (!m_store->save(group.key, stored))
+            ++m_store_errors;
+    }
+
+  public:
+    group_cache() = default;
+    explicit group_cache(group_store store) : m_store{std::move(store)} {}
+
+    // "<places>:<images of one generator>;<images of the next>;...", or
+    // std::nullopt, if there are no generators or their sizes differ
+    static std::optional<std::string>
+    key_of(std::span<const Permutation> generators) {
+        if (generators.empty())
+            return std::nullopt;
+        std::vector<PermutationView> views{};
+        views.reserve(generators.size());
+        for (const auto &g : generators) {
+            if (g.size() != generators.front().size())
+                return std::nullopt;
+            views.push_back(PermutationView{g});
+        }
+        std::ranges::sort(views, cmp_less);
+        const auto [first, last] = std::ranges::unique(views);
+        views.erase(first, last);
+
+        std::string key = std::format("{}:", generators.front().size());
+        for (std::size_t i = 0; i < views.size(); ++i) {
+            if (i != 0zu)
+                key += ';';
+            for (std::size_t x = 0; x < views[i].size(); ++x) {
+                if (x != 0zu)
+                    key += ',';
+                key += std::to_string(views[i][x]);
+            }
+        }
+        return key;
+    }
+
+    // The group generated by `generators`, or nullptr, if they are no
+    // permutations of one size.
+    [[nodiscard]] cached_group *get(std::span<const Permutation> generators) {
+        const auto key = key_of(generators);
+        if (!key)
+            return nullptr;
+        if (auto it = m_groups.find(*key); it != m_groups.end()) {
+            ++m_hits;
+            return &it->second;
+        }
+        for (const auto &g : generators)
+            if (!is_permutation(g))
+                return nullptr;
+
+        const auto places =
+            static_cast<std::uint32_t>(generators.front().size());
+        const std::string store_key = std::format("symetric_group/{}", *key);
+        if (auto group = load(store_key, places)) {
+            ++m_store_hits;
+            return &m_groups.emplace(*key, std::move(*group)).first->second;
+        }
+        ++m_misses;
+
+        cached_group group{
+            .places = places,
+            .key = store_key,
+            .elements = generate_subgroup_from<symetric_group>(generators)};
+        group.element_orders.reserve(group.elements.size());
+        for (const auto &e : group.elements) {
+            const auto order = get_order<symetric_group>(e);
+            if (!order)
+                return nullptr;
+            group.element_orders.push_back(*order);
+        }
+        sort_by_order(group);
+        save(group);
+        return &m_groups.emplace(*key, std::move(group)).first->second;
     }
-    if (true) {
-        std::array<Permutation, 2> array{str_to_perm_or_throw("CAB"),
-                                         str_to_perm_or_throw("ACB")};
-        auto set = generate_subgroup_from<symetric_group>(array);
-        std::vector vec = set | std::ranges::to<std::vector>();
-        std::ranges::sort(vec, compare_by_order<symetric_group>);
-        std::println("<p>the first:</p>");
-        if (!print_table<symetric_group>(vec, {.places = 3}))
-            HTML_error = true;
 
-        auto conjugate_by_elm_of_order3 =
-            get_conjugator(str_to_perm_or_throw("CAB"));
+    // The product table and the cycle types of `group`, see
+    // `export_table_files`. Returns nullptr, if it can not be tabulated. A
+    // new table goes into the store.
+    [[nodiscard]] const tabulation *table_of(cached_group &group) {
+        if (!group.table) {
+            auto cycle_types = cycle_types_of(group.elements);
+            if (!cycle_types)
+                return nullptr;
+            const bool stored = !group.stored_products.empty();
+            group.table = tabulation::create(
+                group.elements, symetric_group{.places = group.places},
+                std::span<const std::uint32_t>{group.stored_products});
+            if (!group.table)
+                return nullptr;
+            group.cycle_types = std::move(*cycle_types);
+            group.stored_products = {};
+            if (!stored)
+                save(group);
+        }
+        return group.table.get();
+    }
 
-        auto vec2 = vec | std::views::transform(conjugate_by_elm_of_order3) |
-                    std::ranges::to<std::vector>();
-        std::println("<p>the second:</p>");
-        if (!print_table<symetric_group>(vec2, {.places = 3}))
-            HTML_error = true;
+    std::size_t size() const { return m_groups.size(); }
+    std::size_t hits() const { return m_hits; }
+    std::size_t store_hits() const { return m_store_hits; }
+    std::size_t misses() const { return m_misses; }
+    std::size_t store_errors() const { return m_store_errors; }
+};
 
-        auto vec3 = vec2 | std::views::transform(conjugate_by_elm_of_order3) |
-                    std::ranges::to<std::vector>();
-        std::println("<p>the third:</p>");
-        if (!print_table<symetric_group>(vec3, {.places = 3}))
-            HTML_error = true;
+// The jobs of `run_jobs`, one per line:
+//
+//   check A B EXPECTED       checks A ∘ B = EXPECTED, see `check_expect`
+//   powers P                 prints the powers of P to stderr
+//   symmetric N              prints the page head and the table of S_N
+//   alternating N            prints the page head and the table of A_N
+//   constrained N [derangements] [band W]
+//                            prints the number of permutations of S_N
+//                            without fixed points and with |π(i) - i| <= W
+//                            and the first of them, as images of 0 .. N-1,
+//                            to stderr, see `calc_constrained_permutation`
+//   tiled N DIR [TILE]       writes the table of S_N in tiles of TILE × TILE
+//                            cells, 64 by default, to DIR, see
+//                            `print_table_tiled`
+//   table G... [by C...]     prints the table of the group generated by G...,
+//                            sorted by order, conjugated by every C in turn
+//   orders G...              prints the number of elements of every order of
+//                            the group generated by G... to stderr
+//   orbits K G...            prints the orbits of the group generated by
+//                            G... on the K-subsets to stderr, see `orbits_of`
+//   cayley G...              prints the word lengths of the group generated
+//                            by G... to stderr, see `word_metrics_of`
+//   export PREFIX G...       exports the table of the group generated by G...,
+//                            see `export_table_files`
+//   bla                      prints the table of `group_bla`
+//   dihedral N               prints the table of D_N = Z_N ⋊ Z_2, see
+//                            `dihedral_group`
+//   subgroups-of-S4          see `print_some_sub_groups_of_S4`
+//
+// Permutations are in one-line notation like "CAB", an appended "'" inverts
+// one. A table can get a title: everything after the first ':' goes into a
+// paragraph before it. Everything after a '#' is a comment.
+namespace job_detail {
+
+constexpr std::string_view trim(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos)
+        return {};
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1zu);
+}
 
-        auto conjugate_by_elm_of_order2 =
-            get_conjugator(str_to_perm_or_throw("ACB"));
+inline std::vector<std::string_view> split_words(std::string_view text) {
+    std::vector<std::string_view> words{};
+    while (true) {
+        text = trim(text);
+        if (text.empty())
+            return words;
+        const auto end = std::min(text.find_first_of(" \t"), text.size());
+        words.push_back(text.substr(0, end));
+        text.remove_prefix(end);
+    }
+}
 
-        auto vec4 = vec3 | std::views::transform(conjugate_by_elm_of_order2) |
-                    std::ranges::to<std::vector>();
-        std::println("<p>the fourth:</p>");
-        if (!print_table<symetric_group>(vec4, {.places = 3}))
-            HTML_error = true;
+template <std::unsigned_integral T>
+[[nodiscard]] bool parse_number(std::string_view word, T &value) {
+    const auto [end, ec] =
+        std::from_chars(word.data(), word.data() + word.size(), value);
+    return ec == std::errc{} && end == word.data() + word.size();
+}
+
+inline std::optional<Permutation> parse_permutation(std::string_view word) {
+    const bool invert = word.ends_with('\'');
+    if (invert)
+        word.remove_suffix(1);
+    auto perm = str_to_perm(word);
+    if (!perm || perm->size() == 0zu || !is_permutation(*perm))
+        return std::nullopt;
+    if (invert)
+        return inverse(*perm);
+    return perm;
+}
+
+inline std::optional<std::vector<Permutation>>
+parse_permutations(std::span<const std::string_view> words) {
+    std::vector<Permutation> perms{};
+    perms.reserve(words.size());
+    for (const auto word : words) {
+        auto perm = parse_permutation(word);
+        if (!perm)
+            return std::nullopt;
+        perms.push_back(std::move(*perm));
     }
+    return perms;
+}
 
-    if (!print_bla_group()) {
-        HTML_error = true;
+} // namespace job_detail
+
+// Runs one job line, see above. Returns an error message, or an empty
+// string.
+[[nodiscard]] std::string run_job(std::string_view line, group_cache &cache) {
+    std::string_view title{};
+    bool has_title = false;
+    if (const auto colon = line.find(':'); colon != std::string_view::npos) {
+        title = job_detail::trim(line.substr(colon + 1zu));
+        has_title = true;
+        line = line.substr(0, colon);
     }
+    const auto words = job_detail::split_words(line);
+    if (words.empty())
+        return has_title ? "title without job" : "";
+    const std::string_view op = words.front();
+    const auto args = std::span{words}.subspan(1);
+    PERMUTATIONS_TRACE_SCOPE(op, job_detail::trim(line));
+    if (has_title && op != "table")
+        return std::format("{} has no title", op);
+
+    auto get_group =
+        [&](std::span<const std::string_view> gens) -> cached_group * {
+        const auto generators = job_detail::parse_permutations(gens);
+        if (!generators)
+            return nullptr;
+        return cache.get(*generators);
+    };
 
-    if (false) {
-        std::println(stderr, "");
+    if (op == "check") {
+        const auto perms = job_detail::parse_permutations(args);
+        if (!perms || perms->size() != 3zu)
+            return "check needs three permutations";
+        check_expect((*perms)[0], (*perms)[1], (*perms)[2]);
+    } else if (op == "powers") {
+        const auto perms = job_detail::parse_permutations(args);
+        if (!perms || perms->size() != 1zu)
+            return "powers needs one permutation";
+        print_all_powers(stderr, perms->front());
+    } else if (op == "symmetric" || op == "alternating") {
+        std::uint32_t places{};
+        const auto word = args.empty() ? std::string_view{} : args.front();
+        const auto [end, ec] =
+            std::from_chars(word.data(), word.data() + word.size(), places);
+        if (args.size() != 1zu || ec != std::errc{} ||
+            end != word.data() + word.size())
+            return std::format("{} needs a degree", op);
+        if (!print_group_table(places, false, false, op == "alternating"))
+            return "error printing html table";
+    } else if (op == "tiled") {
+        std::uint32_t places{};
+        std::size_t tile_size = 64;
+        if (args.size() < 2zu || args.size() > 3zu ||
+            !job_detail::parse_number(args[0], places) ||
+            (args.size() == 3zu &&
+             (!job_detail::parse_number(args[2], tile_size) ||
+              tile_size == 0zu)))
+            return "tiled needs a degree, a directory and a tile size";
+        if (!write_tiled_group_table(places, args[1], tile_size))
+            return "error writing the tiles";
+    } else if (op == "constrained") {
+        std::size_t places{};
+        if (args.empty() || !job_detail::parse_number(args[0], places) ||
+            places > permutation_constraints::max_places)
+            return "constrained needs a degree up to 64";
+        bool derangements = false;
+        std::optional<std::size_t> width{};
+        for (std::size_t i = 1; i < args.size(); ++i) {
+            std::size_t w{};
+            if (args[i] == "derangements") {
+                derangements = true;
+            } else if (args[i] == "band" && i + 1zu < args.size() &&
+                       job_detail::parse_number(args[++i], w)) {
+                width = w;
+            } else {
+                return "constrained takes derangements and band WIDTH";
+            }
+        }
+        auto constraints = derangements
+                               ? permutation_constraints::derangements(places)
+                               : permutation_constraints::none(places);
+        for (std::size_t x = 0; width && x < places; ++x)
+            for (std::size_t y = 0; y < places; ++y)
+                if (std::max(x, y) - std::min(x, y) > *width)
+                    constraints.forbid(x, y);
+
+        std::uint64_t count = 0;
+        // as numbers, the letters of the formatter end at 26 points
+        std::string first{};
+        calc_constrained_permutation<void>(
+            [&](PermutationView perm) {
+                if (count++ != 0u)
+                    return;
+                for (const auto image : perm)
+                    std::format_to(std::back_inserter(first), " {}", image);
+            },
+            constraints);
+        std::println(stderr, "{} permutations{}", count,
+                     count == 0u ? "" : ", the first is" + first);
+    } else if (op == "table") {
+        const auto by = std::ranges::find(args, std::string_view{"by"});
+        const auto gens = std::span{args.begin(), by};
+        const auto conjugators = job_detail::parse_permutations(
+            by == args.end() ? std::span<const std::string_view>{}
+                             : std::span{by + 1, args.end()});
+        cached_group *group = get_group(gens);
+        if (!group || !conjugators)
+            return "table needs permutations of one size";
+
+        std::span<const Permutation> elements = group->by_order;
+        std::vector<Permutation> conjugated{};
+        for (const auto &c : *conjugators) {
+            if (c.size() != group->places)
+                return "table needs permutations of one size";
+            conjugated = elements | std::views::transform(get_conjugator(c)) |
+                         std::ranges::to<std::vector>();
+            elements = conjugated;
+        }
+        if (has_title)
+            std::println("<p>{}</p>", title);
+        if (!print_table<symetric_group>(elements, {.places = group->places}))
+            return "error printing html table";
+    } else if (op == "orbits") {
+        std::uint32_t k{};
+        const auto word = args.empty() ? std::string_view{} : args.front();
+        const auto [end, ec] =
+            std::from_chars(word.data(), word.data() + word.size(), k);
+        if (args.empty() || ec != std::errc{} ||
+            end != word.data() + word.size())
+            return "orbits needs a subset size";
+        const auto generators =
+            job_detail::parse_permutations(args.subspan(1));
+        if (!generators || generators->empty())
+            return "orbits needs generators";
+        const auto places =
+            static_cast<std::uint32_t>(generators->front().size());
+        permutation_arena arena(places);
+        for (const auto &g : *generators) {
+            if (g.size() != places)
+                return "orbits needs permutations of one size";
+            std::ranges::copy(g.get_readonly_span(), arena.append().begin());
+        }
+        const auto domain = k_subset_domain::create(places, k);
+        if (!domain)
+            return "orbits needs a subset size up to the degree";
+        const auto decomposition = orbits_of(*domain, arena);
+        if (!decomposition)
+            return "orbits needs permutations";
+        std::println(stderr, "{} orbits on the {}-subsets:",
+                     decomposition->orbits.size(), k);
+        std::vector<std::uint32_t> subset(k);
+        for (const auto &orbit : decomposition->orbits) {
+            domain->unrank(orbit.front(), subset);
+            std::string name = "{";
+            for (const auto point : subset)
+                name += index_to_char(point, places).value_or('?');
+            name += '}';
+            std::println(stderr, "- {} with {} elements", name, orbit.size());
+        }
+    } else if (op == "cayley") {
+        const auto generators = job_detail::parse_permutations(args);
+        if (!generators || generators->empty())
+            return "cayley needs generators";
+        const auto places =
+            static_cast<std::uint32_t>(generators->front().size());
+        permutation_arena arena(places);
+        for (const auto &g : *generators) {
+            if (g.size() != places)
+                return "cayley needs permutations of one size";
+            std::ranges::copy(g.get_readonly_span(), arena.append().begin());
+        }
+        const auto graph = cayley_graph::create(arena);
+        if (!graph)
+            return "cayley needs permutations";
+        const word_metrics metrics = word_metrics_of(*graph);
+        std::println(stderr, "group of order {}, diameter {}:", graph->size(),
+                     metrics.diameter());
+        for (std::size_t length = 0; length < metrics.distribution.size();
+             ++length)
+            std::println(stderr, "- {} elements of word length {}",
+                         metrics.distribution[length], length);
+        // the last element found is one of the longest
+        const auto word = metrics.shortest_word(
+            *graph, static_cast<std::uint32_t>(graph->size() - 1zu));
+        std::string text{};
+        for (const auto g : word.value())
+            text += std::format(" {}", args[g]);
+        std::println(stderr, "a longest element:{}", text);
+    } else if (op == "orders") {
+        const cached_group *group = get_group(args);
+        if (!group)
+            return "orders needs permutations of one size";
+        std::map<std::size_t, std::size_t> counts{};
+        for (const auto order : group->orders)
+            ++counts[order];
+        std::println(stderr, "group of order {}:", group->elements.size());
+        for (const auto [order, count] : counts)
+            std::println(stderr, "- {} elements of order {}", count, order);
+    } else if (op == "export") {
+        if (args.empty())
+            return "export needs a path prefix";
+        cached_group *group = get_group(args.subspan(1));
+        if (!group)
+            return "export needs permutations of one size";
+        const tabulation *table = cache.table_of(*group);
+        if (!table ||
+            !export_table_files(*table, group->cycle_types, args.front()))
+            return "error exporting the table";
+    } else if (op == "bla") {
+        if (!args.empty())
+            return "bla has no arguments";
+        if (!print_bla_group())
+            return "error printing html table";
+    } else if (op == "dihedral") {
+        std::uint32_t n{};
+        const auto word = args.empty() ? std::string_view{} : args.front();
+        const auto [end, ec] =
+            std::from_chars(word.data(), word.data() + word.size(), n);
+        if (args.size() != 1zu || ec != std::errc{} ||
+            end != word.data() + word.size() || n == 0u)
+            return "dihedral needs a positive n";
+        if (!print_dihedral_group(n))
+            return "error printing html table";
+    } else if (op == "subgroups-of-S4") {
+        if (!args.empty())
+            return "subgroups-of-S4 has no arguments";
         if (!print_some_sub_groups_of_S4())
-            HTML_error = true;
+            return "error printing html table";
+    } else {
+        return std::format("unknown job {}", op);
+    }
+    return {};
+}
+
+// Runs all jobs of `jobs`, see `run_job`, all of them with `cache`. A failing
+// job is reported with its line number, and the following ones still run.
+// Returns false, if one of them failed.
+[[nodiscard]] bool run_jobs(std::string_view jobs, group_cache &cache) {
+    bool ok = true;
+    std::size_t line_number = 0;
+    while (!jobs.empty()) {
+        ++line_number;
+        const std::size_t end = jobs.find('\n');
+        std::string_view line = jobs.substr(0, end);
+        jobs.remove_prefix(end == std::string_view::npos ? jobs.size()
+                                                         : end + 1zu);
+        line = line.substr(0, line.find('#'));
+
+        std::string error{};
+        try {
+            error = run_job(line, cache);
+        } catch (const std::exception &) {
+            error = "failed";
+        }
+        if (!error.empty()) {
+            std::println(stderr, "job in line {}: {}", line_number, error);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// The jobs without a job file.
+inline constexpr std::string_view default_jobs = R"(
+check ABC ABC ABC
+check ABC CAB CAB
+check CAB ABC CAB
+check CAB CAB' ABC
+powers BCA
+symmetric 3
+table CAB ACB : the first:
+table CAB ACB by CAB : the second:
+table CAB ACB by CAB CAB : the third:
+table CAB ACB by CAB CAB ACB : the fourth:
+bla
+)";
+
+} // namespace permutations
+
+// Usage: permutationen [--cache DIRECTORY] [--trace FILE] [JOB_FILE]
+// Runs the jobs of JOB_FILE, or of stdin for "-", see `run_jobs`, and prints
+// the HTML page to stdout. Without a job file it runs `default_jobs`. With
+// --cache the groups are kept in a `group_store` in DIRECTORY. With --trace
+// the timeline of the phases is written to FILE, see phase-trace.h.
+int main(int argc, char *argv[]) {
+    using namespace permutations;
+
+    std::span<char *> args{argv + 1, static_cast<std::size_t>(argc - 1)};
+    std::optional<std::string_view> cache_directory{};
+    std::optional<std::string> trace_file{};
+    while (args.size() >= 2zu) {
+        const std::string_view option = args[0];
+        if (option == "--cache")
+            cache_directory = args[1];
+        else if (option == "--trace")
+            trace_file = args[1];
+        else
+            break;
+        args = args.subspan(2);
+    }
+    if (args.size() > 1zu) {
+        std::println(stderr,
+                     "usage: {} [--cache DIRECTORY] [--trace FILE] [JOB_FILE]",
+                     argv[0]);
+        return 2;
+    }
+    if (trace_file && !PERMUTATIONS_TRACING) {
+        std::println(stderr, "--trace needs a build with "
+                             "PERMUTATIONS_ENABLE_TRACING");
+        return 2;
     }
+    std::string jobs{default_jobs};
+    if (args.size() == 1zu) {
+        const std::string_view path = args[0];
+        std::FILE *file = path == "-" ? stdin : std::fopen(args[0], "rb");
+        if (!file) {
+            std::println(stderr, "can not open {}", path);
+            return 2;
+        }
+        jobs.clear();
+        char block[4096];
+        while (const std::size_t n = std::fread(block, 1, sizeof block, file))
+            jobs.append(block, n);
+        const bool read_error = std::ferror(file) != 0;
+        if (file != stdin)
+            std::fclose(file);
+        if (read_error) {
+            std::println(stderr, "can not read {}", path);
+            return 2;
+        }
+    }
+
+    group_cache cache{};
+    if (cache_directory) {
+        auto store = group_store::open(*cache_directory);
+        if (!store) {
+            std::println(stderr, "can not open {}", *cache_directory);
+            return 2;
+        }
+        cache = group_cache{std::move(*store)};
+    }
+    const bool ok = run_jobs(jobs, cache);
+    std::println(stderr, "group cache: {} groups, {} hits, {} misses",
+                 cache.size(), cache.hits(), cache.misses());
+    if (cache_directory)
+        std::println(stderr, "group store: {} hits, {} write errors",
+                     cache.store_hits(), cache.store_errors());
     std::println(stdout, "</body></html>");
+#if PERMUTATIONS_TRACING
+    if (trace_file && !trace_recorder::instance().write(*trace_file)) {
+        std::println(stderr, "can not write {}", *trace_file);
+        return 1;
+    }
+#endif
     //print_binary_permutation(10,5); // n over k, binomal coefficient
     //print_ternary_permutation(1,1,5);
 
-    if (HTML_error)
+    if (!ok)
         return 1;
     return 0;
 }
@@ -0,0 +1,163 @@
+#pragma once
+
+// Scoped timers for the phases of a run, like enumeration, sorting, closure
+// and rendering, and for every job. They are written as a Chrome trace-event
+// JSON file, that chrome://tracing or https://ui.perfetto.dev show as a
+// timeline. Tracing only exists with PERMUTATIONS_TRACING defined as 1, see
+// the cmake option PERMUTATIONS_ENABLE_TRACING. Otherwise
+// `PERMUTATIONS_TRACE_SCOPE(...)` expands to nothing, its arguments are not
+// evaluated, and nothing of this header is compiled.
+//
+//     PERMUTATIONS_TRACE_SCOPE("sort by order");
+//     PERMUTATIONS_TRACE_SCOPE("job", line); // with a detail shown as arg
+
+#ifndef PERMUTATIONS_TRACING
+#define PERMUTATIONS_TRACING 0
+#endif
+
+#if PERMUTATIONS_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace permutations {
+
+// The finished scopes of all threads. Scopes are coarse, whole phases, so
+// one mutex for all of them costs nothing measurable.
+class trace_recorder {
+    struct event {
+        std::string name{};
+        std::string detail{};
+        std::int64_t begin{};    // ns since the start of the run
+        std::int64_t duration{}; // ns
+        std::uint32_t thread{};
+    };
+
+    std::chrono::steady_clock::time_point m_start =
+        std::chrono::steady_clock::now();
+    std::mutex m_mutex{};
+    std::vector<event> m_events{};
+    std::atomic<std::uint32_t> m_threads{};
+
+    static void append_json_string(std::string &out, std::string_view text) {
+        out += '"';
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20u) {
+                out += std::format("\\u{:04x}", static_cast<unsigned>(c));
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+  public:
+    static trace_recorder &instance() {
+        static trace_recorder recorder{};
+        return recorder;
+    }
+
+    // A small number for the calling thread, in the order of first use.
+    std::uint32_t thread_number() {
+        thread_local const std::uint32_t number = m_threads++;
+        return number;
+    }
+
+    void record(std::string name, std::string detail,
+                std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end) {
+        using std::chrono::nanoseconds;
+        event e{.name = std::move(name),
+                .detail = std::move(detail),
+                .begin = std::chrono::duration_cast<nanoseconds>(begin -
+                                                                 m_start)
+                             .count(),
+                .duration =
+                    std::chrono::duration_cast<nanoseconds>(end - begin)
+                        .count(),
+                .thread = thread_number()};
+        const std::lock_guard lock{m_mutex};
+        m_events.push_back(std::move(e));
+    }
+
+    // Writes all events recorded so far as complete ("X") events. Returns
+    // false, if the file could not be written.
+    [[nodiscard]] bool write(const std::string &path) {
+        std::string out = R"({"displayTimeUnit":"ms","traceEvents":[)";
+        {
+            const std::lock_guard lock{m_mutex};
+            for (bool first = true; const event &e : m_events) {
+                if (!std::exchange(first, false))
+                    out += ',';
+                out += R"({"name":)";
+                append_json_string(out, e.name);
+                out += std::format(
+                    R"(,"cat":"phase","ph":"X","pid":1,"tid":{},)"
+                    R"("ts":{}.{:03},"dur":{}.{:03})",
+                    e.thread, e.begin / 1000, e.begin % 1000,
+                    e.duration / 1000, e.duration % 1000);
+                if (!e.detail.empty()) {
+                    out += R"(,"args":{"detail":)";
+                    append_json_string(out, e.detail);
+                    out += '}';
+                }
+                out += '}';
+            }
+        }
+        out += "]}\n";
+
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+        ok = std::fclose(file) == 0 && ok;
+        return ok;
+    }
+};
+
+// Records the time from its construction to its destruction.
+class trace_scope {
+    // first, so that the run starts before the first scope
+    trace_recorder &m_recorder = trace_recorder::instance();
+    std::string m_name;
+    std::string m_detail;
+    std::chrono::steady_clock::time_point m_begin =
+        std::chrono::steady_clock::now();
+
+  public:
+    explicit trace_scope(std::string_view name, std::string_view detail = {})
+        : m_name{name}, m_detail{detail} {}
+    trace_scope(const trace_scope &) = delete;
+    trace_scope &operator=(const trace_scope &) = delete;
+    ~trace_scope() {
+        m_recorder.record(std::move(m_name), std::move(m_detail), m_begin,
+                          std::chrono::steady_clock::now());
+    }
+};
+
+} // namespace permutations
+
+#define PERMUTATIONS_TRACE_CONCAT_IMPL(a, b) a##b
+#define PERMUTATIONS_TRACE_CONCAT(a, b) PERMUTATIONS_TRACE_CONCAT_IMPL(a, b)
+#define PERMUTATIONS_TRACE_SCOPE(...)                                          \
+    const ::permutations::trace_scope PERMUTATIONS_TRACE_CONCAT(               \
+        permutations_trace_scope_, __LINE__) {                                 \
+        __VA_ARGS__                                                            \
+    }
+
+#else
+
+#define PERMUTATIONS_TRACE_SCOPE(...) static_cast<void>(0)
+
+#endif
@@ -0,0 +1,348 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "group-interface.h"
+
+namespace permutations {
+
+// Groups built from other groups: the direct product G1 × G2 and the
+// semidirect product N ⋊ H. An element is a pair of elements of the factors,
+// stored inline, so a product of two small groups is as small as its
+// factors and needs no allocation. Composition is component-wise and
+// inlined into the caller. The products satisfy `group_config_c`, so they
+// work with `generate_subgroup_from`, `tabulation` and `print_table` like
+// any other group, and can be factors of products themselves. Being class
+// templates, they implement the group interface as static members, see
+// group-interface.h.
+
+// The cyclic group Z_n, the simplest factor of products, e.g. of the dihedral
+// group Z_n ⋊ Z_2.
+struct cyclic_group;
+struct cyclic_element {
+    std::uint32_t value{};
+    std::uint32_t order{};
+
+    constexpr explicit operator cyclic_group() const;
+    constexpr bool operator==(const cyclic_element &) const = default;
+    std::string to_string() const {
+        return std::format("Z{}_{}", order, value);
+    }
+};
+
+inline constexpr auto cmp_cyclic_element = [](cyclic_element a,
+                                              cyclic_element b) -> bool {
+    if (a.order != b.order)
+        return a.order < b.order;
+    return a.value < b.value;
+};
+
+struct cyclic_group {
+    using element_type = cyclic_element;
+    using element_view_type = cyclic_element;
+    using compare_type = decltype(cmp_cyclic_element);
+
+    std::uint32_t order = 1;
+
+    // g^k, or std::nullopt, if the group is empty.
+    constexpr std::optional<cyclic_element> power(std::uint64_t k) const {
+        if (order == 0u)
+            return std::nullopt;
+        return cyclic_element{static_cast<std::uint32_t>(k % order), order};
+    }
+};
+static_assert(group_config_c<cyclic_group>);
+
+constexpr cyclic_element::operator cyclic_group() const { return {order}; }
+
+template <>
+constexpr typename cyclic_group::element_type get_identity(cyclic_group g) {
+    return {0u, g.order};
+}
+
+template <>
+inline std::optional<cyclic_element>
+compose_permutations<cyclic_group>(cyclic_element a, cyclic_element b) {
+    if (a.order != b.order || a.order == 0u)
+        return std::nullopt;
+    return cyclic_element{static_cast<std::uint32_t>(
+                              (std::uint64_t{a.value} + b.value) % a.order),
+                          a.order};
+}
+
+template <>
+inline std::optional<std::string>
+get_other_representation<cyclic_group>(cyclic_element a) {
+    if (a.value == 0u)
+        return "e";
+    if (a.value == 1u)
+        return "g";
+    return std::format("g<sup>{}</sup>", a.value);
+}
+
+template <group_config_c G1, group_config_c G2, typename Product>
+struct product_element;
+
+// A pair of views of the factors.
+template <group_config_c G1, group_config_c G2, typename Product>
+struct product_view {
+    typename G1::element_view_type first;
+    typename G2::element_view_type second;
+
+    constexpr product_view(typename G1::element_view_type first,
+                           typename G2::element_view_type second)
+        : first{std::move(first)}, second{std::move(second)} {}
+    constexpr product_view(const product_element<G1, G2, Product> &e)
+        : first{e.first}, second{e.second} {}
+
+    constexpr explicit operator Product() const {
+        return Product{static_cast<G1>(first), static_cast<G2>(second)};
+    }
+    constexpr bool operator==(const product_view &other) const {
+        return first == other.first && second == other.second;
+    }
+    // Only letters, digits, '-' and '_', so the name can be an html class.
+    std::string to_string() const {
+        return std::format("{}_{}", first.to_string(), second.to_string());
+    }
+};
+
+template <group_config_c G1, group_config_c G2, typename Product>
+struct product_element {
+    typename G1::element_type first{};
+    typename G2::element_type second{};
+
+    constexpr explicit operator Product() const {
+        return static_cast<Product>(product_view<G1, G2, Product>{*this});
+    }
+    constexpr bool operator==(const product_element &other) const {
+        return product_view<G1, G2, Product>{*this} ==
+               product_view<G1, G2, Product>{other};
+    }
+    std::string to_string() const {
+        return product_view<G1, G2, Product>{*this}.to_string();
+    }
+};
+
+// Lexicographic, first by the first factor.
+template <group_config_c G1, group_config_c G2, typename Product>
+struct product_less {
+    constexpr bool operator()(const product_view<G1, G2, Product> &a,
+                              const product_view<G1, G2, Product> &b) const {
+        const typename G1::compare_type less_first{};
+        if (less_first(a.first, b.first))
+            return true;
+        if (less_first(b.first, a.first))
+            return false;
+        return typename G2::compare_type{}(a.second, b.second);
+    }
+};
+
+namespace product_detail {
+
+// The group interface of `direct_product` and `semidirect_product`.
+
+template <typename Product>
+constexpr typename Product::element_type identity(const Product &g) {
+    using G1 = typename Product::first_config;
+    using G2 = typename Product::second_config;
+    return {get_identity<G1>(g.first), get_identity<G2>(g.second)};
+}
+
+template <typename Product>
+inline std::optional<typename Product::element_type>
+compose(const typename Product::element_view_type &a,
+        const typename Product::element_view_type &b) {
+    using G1 = typename Product::first_config;
+    using G2 = typename Product::second_config;
+    std::optional<typename G1::element_type> first{};
+    if constexpr (requires { typename Product::action_type; }) {
+        const auto acted = typename Product::action_type{}(a.second, b.first);
+        if (!acted)
+            return std::nullopt;
+        first = compose_permutations<G1>(
+            a.first, typename G1::element_view_type{*acted});
+    } else {
+        first = compose_permutations<G1>(a.first, b.first);
+    }
+    if (!first)
+        return std::nullopt;
+    auto second = compose_permutations<G2>(a.second, b.second);
+    if (!second)
+        return std::nullopt;
+    return typename Product::element_type{std::move(*first),
+                                          std::move(*second)};
+}
+
+template <typename Product>
+std::optional<std::string>
+other_representation(const typename Product::element_view_type &a) {
+    using G1 = typename Product::first_config;
+    using G2 = typename Product::second_config;
+    auto first = get_other_representation<G1>(a.first);
+    auto second = get_other_representation<G2>(a.second);
+    if (!first || !second)
+        return std::nullopt;
+    return std::format("({}, {})", *first, *second);
+}
+
+} // namespace product_detail
+
+// G1 × G2: (a1, a2)(b1, b2) = (a1 b1, a2 b2).
+template <group_config_c G1, group_config_c G2> struct direct_product {
+    using first_config = G1;
+    using second_config = G2;
+    using element_type = product_element<G1, G2, direct_product>;
+    using element_view_type = product_view<G1, G2, direct_product>;
+    using compare_type = product_less<G1, G2, direct_product>;
+
+    G1 first{};
+    G2 second{};
+
+    static constexpr element_type identity(const direct_product &g) {
+        return product_detail::identity(g);
+    }
+    static std::optional<element_type> compose(const element_view_type &a,
+                                               const element_view_type &b) {
+        return product_detail::compose<direct_product>(a, b);
+    }
+    static std::optional<std::string>
+    other_representation(const element_view_type &a) {
+        return product_detail::other_representation<direct_product>(a);
+    }
+};
+
+// N ⋊ H: (n1, h1)(n2, h2) = (n1 φ(h1)(n2), h1 h2), with φ = `Action`, a
+// default constructible callable, that maps (h, n) to φ(h)(n) as an
+// std::optional of an element of N. It has to be a homomorphism from H to
+// the automorphisms of N, else the product is no group; this is not checked.
+template <group_config_c N, group_config_c H, typename Action>
+    requires std::default_initializable<Action> &&
+             std::is_invocable_r_v<std::optional<typename N::element_type>,
+                                   const Action &, typename H::element_view_type,
+                                   typename N::element_view_type>
+struct semidirect_product {
+    using first_config = N;
+    using second_config = H;
+    using action_type = Action;
+    using element_type = product_element<N, H, semidirect_product>;
+    using element_view_type = product_view<N, H, semidirect_product>;
+    using compare_type = product_less<N, H, semidirect_product>;
+
+    N first{};
+    H second{};
+
+    static constexpr element_type identity(const semidirect_product &g) {
+        return product_detail::identity(g);
+    }
+    static std::optional<element_type> compose(const element_view_type &a,
+                                               const element_view_type &b) {
+        return product_detail::compose<semidirect_product>(a, b);
+    }
+    static std::optional<std::string>
+    other_representation(const element_view_type &a) {
+        return product_detail::other_representation<semidirect_product>(a);
+    }
+};
+
+// φ(h)(n) = n^((-1)^h) for H = Z_2, or any Z_2k, and N = Z_n; Z_n ⋊ Z_2 is
+// the dihedral group of order 2n.
+struct inversion_action {
+    constexpr std::optional<cyclic_element>
+    operator()(cyclic_element h, cyclic_element n) const {
+        if (h.order % 2u != 0u || n.order == 0u)
+            return std::nullopt;
+        if (h.value % 2u == 0u)
+            return n;
+        return cyclic_element{(n.order - n.value) % n.order, n.order};
+    }
+};
+
+using dihedral_group = semidirect_product<cyclic_group, cyclic_group,
+                                          inversion_action>;
+static_assert(group_config_c<dihedral_group>);
+
+// D_n with the rotation r and the reflection s, the usual generators.
+constexpr dihedral_group make_dihedral_group(std::uint32_t n) {
+    return {cyclic_group{n}, cyclic_group{2u}};
+}
+constexpr dihedral_group::element_type dihedral_rotation(std::uint32_t n) {
+    return {cyclic_element{1u % n, n}, cyclic_element{0u, 2u}};
+}
+constexpr dihedral_group::element_type dihedral_reflection(std::uint32_t n) {
+    return {cyclic_element{0u, n}, cyclic_element{1u, 2u}};
+}
+
+} // namespace permutations
+
+template <> struct std::formatter<permutations::cyclic_element, char> {
+    template <class ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext &ctx) {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it != '}')
+            throw std::format_error("Invalid format args for cyclic_element.");
+        return it;
+    }
+
+    template <typename FmtContext>
+    FmtContext::iterator format(const permutations::cyclic_element &e,
+                                FmtContext &ctx) const {
+        return std::format_to(ctx.out(), "{}", e.value);
+    }
+};
+static_assert(std::formattable<permutations::cyclic_element, char>);
+
+// "(a,b)" with the labels of the factors, without a space, because labels
+// are html classes, too; "{:b}" gives the other representation instead.
+template <permutations::group_config_c G1, permutations::group_config_c G2,
+          typename Product>
+struct std::formatter<permutations::product_view<G1, G2, Product>, char> {
+
+    unsigned repr_b : 1 = 0;
+
+    template <class ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext &ctx) {
+        auto it = ctx.begin();
+        for (; it != ctx.end() && *it != '}'; ++it) {
+            if (*it == 'b')
+                repr_b = true;
+            else if (*it != 'a')
+                throw std::format_error(
+                    "Invalid format args for product elements.");
+        }
+        return it;
+    }
+
+    template <typename FmtContext>
+    FmtContext::iterator
+    format(const permutations::product_view<G1, G2, Product> &v,
+           FmtContext &ctx) const {
+        if (repr_b) {
+            const auto other =
+                permutations::get_other_representation<Product>(v);
+            return std::ranges::copy(std::string_view{other.value_or("?")},
+                                     ctx.out())
+                .out;
+        }
+        return std::format_to(ctx.out(), "({},{})", v.first, v.second);
+    }
+};
+
+template <permutations::group_config_c G1, permutations::group_config_c G2,
+          typename Product>
+struct std::formatter<permutations::product_element<G1, G2, Product>, char>
+    : std::formatter<permutations::product_view<G1, G2, Product>, char> {
+    template <typename FmtContext>
+    FmtContext::iterator
+    format(const permutations::product_element<G1, G2, Product> &e,
+           FmtContext &ctx) const {
+        return std::formatter<permutations::product_view<G1, G2, Product>,
+                              char>::format(e, ctx);
+    }
+};
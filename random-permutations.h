@@ -0,0 +1,309 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "compact-permutations.h"
+
+namespace permutations {
+
+// Random permutations, for Monte-Carlo estimates in groups that are too large
+// to enumerate. Permutations are plain arrays of images here, like the spans
+// of `Permutation`: perm[i] is the image of i, and a ∘ b maps i to a[b[i]].
+// The samples go into a `compact_permutation_arena`, so the size of a sample
+// is bounded by the memory of its narrow entries.
+
+// splitmix64, only used to expand seeds
+constexpr std::uint64_t splitmix64(std::uint64_t &state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15u);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256** by David Blackman and Sebastiano Vigna: fast, 256 bits of
+// state, and good enough for everything but cryptography. Satisfies
+// std::uniform_random_bit_generator.
+class xoshiro256ss {
+    std::array<std::uint64_t, 4> m_state{};
+
+    static constexpr std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+  public:
+    using result_type = std::uint64_t;
+
+    explicit constexpr xoshiro256ss(std::uint64_t seed = 0) {
+        for (auto &s : m_state)
+            s = splitmix64(seed);
+    }
+
+    // The generator for stream `index` of `seed`. The same seed and index
+    // always give the same numbers, no matter which thread asks for them.
+    static constexpr xoshiro256ss stream(std::uint64_t seed,
+                                         std::uint64_t index) {
+        std::uint64_t mixed = seed;
+        const std::uint64_t first = splitmix64(mixed);
+        std::uint64_t stream_seed = index;
+        return xoshiro256ss{first ^ splitmix64(stream_seed)};
+    }
+
+    static constexpr result_type min() { return 0u; }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    constexpr result_type operator()() {
+        const std::uint64_t result = rotl(m_state[1] * 5u, 7) * 9u;
+        const std::uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound), without the bias of `% bound` and almost always
+    // without a division, see Daniel Lemire, "Fast Random Integer Generation
+    // in an Interval", ACM TOMACS 2019.
+    constexpr std::uint32_t below(std::uint32_t bound) {
+        assert(bound != 0u);
+        std::uint64_t m = ((*this)() >> 32) * bound;
+        if (static_cast<std::uint32_t>(m) < bound) {
+            const std::uint32_t threshold = -bound % bound;
+            while (static_cast<std::uint32_t>(m) < threshold)
+                m = ((*this)() >> 32) * bound;
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+};
+
+// Writes a uniformly distributed permutation into `perm`, with the "inside
+// out" Fisher–Yates shuffle, which needs no identity to start from.
+template <std::unsigned_integral Entry>
+constexpr void random_permutation_into(std::span<Entry> perm,
+                                       xoshiro256ss &rng) {
+    assert(entry_fits<Entry>(perm.size()) &&
+           std::cmp_less_equal(perm.size(),
+                               std::numeric_limits<std::uint32_t>::max()));
+    for (std::uint32_t i = 0; i < perm.size(); ++i) {
+        const std::uint32_t j = rng.below(i + 1u);
+        perm[i] = perm[j];
+        perm[j] = static_cast<Entry>(i);
+    }
+}
+
+// Samples are generated in blocks of this size, block b from
+// `xoshiro256ss::stream(seed, b)`. So the samples only depend on the seed,
+// not on the number of threads.
+inline constexpr std::size_t sample_block_size = 4096zu;
+
+// Runs `fill(first, last, rng)` for every block of [0, count) on
+// `number_of_threads` threads.
+template <typename Fill>
+void for_each_sample_block(std::size_t count, std::uint64_t seed,
+                           std::size_t number_of_threads, Fill &&fill) {
+    const std::size_t blocks =
+        (count + sample_block_size - 1zu) / sample_block_size;
+    number_of_threads =
+        std::clamp(number_of_threads, 1zu, std::max(blocks, 1zu));
+    std::vector<std::jthread> threads{};
+    threads.reserve(number_of_threads);
+    for (std::size_t t = 0; t < number_of_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (std::size_t b = t; b < blocks; b += number_of_threads) {
+                auto rng = xoshiro256ss::stream(seed, b);
+                const std::size_t first = b * sample_block_size;
+                fill(first, std::min(first + sample_block_size, count), rng);
+            }
+        });
+    }
+}
+
+// `count` uniformly distributed elements of S_`places`.
+inline compact_permutation_arena sample_uniform_permutations(
+    std::size_t places, std::size_t count, std::uint64_t seed,
+    std::size_t number_of_threads = std::thread::hardware_concurrency()) {
+    compact_permutation_arena samples(places, count);
+    samples.visit([&](auto &arena) {
+        for_each_sample_block(
+            count, seed, number_of_threads,
+            [&](std::size_t first, std::size_t last, xoshiro256ss &rng) {
+                for (std::size_t i = first; i < last; ++i)
+                    random_permutation_into(arena.slot(i), rng);
+            });
+    });
+    return samples;
+}
+
+// Random elements of the group generated by some permutations, with the
+// product replacement algorithm in its "rattle" variant with accumulator,
+// see Leedham-Green and Murray, "Variants of product replacement",
+// Contemp. Math. 298 (2002). A state of a few group elements is mixed by
+// multiplying one of them with another or its inverse; the accumulator
+// collects the new elements. After the burn-in the outputs are close to
+// uniform, but consecutive outputs are not independent.
+class product_replacement_sampler {
+    std::size_t m_places{};
+    std::size_t m_number_of_slots{};
+    std::vector<std::uint32_t> m_slots{};
+    std::vector<std::uint32_t> m_accumulator{};
+    std::vector<std::uint32_t> m_scratch{};
+    std::vector<std::uint32_t> m_inverse{};
+
+    std::span<std::uint32_t> slot(std::size_t index) {
+        return std::span{m_slots}.subspan(index * m_places, m_places);
+    }
+
+    void step(xoshiro256ss &rng) {
+        const std::uint32_t slots =
+            static_cast<std::uint32_t>(m_number_of_slots);
+        const std::uint32_t s = rng.below(slots);
+        std::uint32_t t = rng.below(slots - 1u);
+        t += t >= s ? 1u : 0u;
+        const std::uint64_t coin = rng();
+        const bool invert = (coin & 1u) != 0u;
+        const bool from_left = (coin & 2u) != 0u;
+
+        auto a = slot(s);
+        const auto b = slot(t);
+        std::uint32_t *out = m_scratch.data();
+        // a ∘ b^e or b^e ∘ a
+        if (!from_left && !invert) {
+            for (std::size_t i = 0; i < m_places; ++i)
+                out[i] = a[b[i]];
+        } else if (!from_left) {
+            for (std::size_t i = 0; i < m_places; ++i)
+                out[b[i]] = a[i];
+        } else if (!invert) {
+            for (std::size_t i = 0; i < m_places; ++i)
+                out[i] = b[a[i]];
+        } else {
+            std::uint32_t *inverse = m_inverse.data();
+            for (std::uint32_t i = 0; i < m_places; ++i)
+                inverse[b[i]] = i;
+            for (std::size_t i = 0; i < m_places; ++i)
+                out[i] = inverse[a[i]];
+        }
+        std::ranges::copy(std::span{out, m_places}, a.begin());
+
+        // accumulator ∘ a
+        for (std::size_t i = 0; i < m_places; ++i)
+            out[i] = m_accumulator[a[i]];
+        m_accumulator.swap(m_scratch);
+    }
+
+  public:
+    static constexpr std::size_t default_burn_in = 64zu;
+
+    // `generators` is a range of ranges of images. Returns std::nullopt, if
+    // there are none, if their sizes differ or if one of them is no
+    // permutation.
+    template <std::ranges::input_range R>
+    [[nodiscard]] static std::optional<product_replacement_sampler>
+    create(R &&generators, xoshiro256ss &rng,
+           std::size_t burn_in = default_burn_in) {
+        product_replacement_sampler sampler{};
+        std::vector<std::uint32_t> &slots = sampler.m_slots;
+        std::size_t number_of_generators = 0;
+        std::vector<char> seen{};
+        for (const auto &generator : generators) {
+            const std::size_t places = std::ranges::size(generator);
+            if (number_of_generators == 0zu)
+                sampler.m_places = places;
+            else if (places != sampler.m_places)
+                return std::nullopt;
+            seen.assign(places, false);
+            for (const auto image : generator) {
+                if (std::cmp_greater_equal(image, places) || seen[image])
+                    return std::nullopt;
+                seen[image] = true;
+                slots.push_back(static_cast<std::uint32_t>(image));
+            }
+            ++number_of_generators;
+        }
+        if (number_of_generators == 0zu)
+            return std::nullopt;
+
+        // at least ten slots, the generators repeated
+        const std::size_t places = sampler.m_places;
+        sampler.m_number_of_slots = std::max(10zu, number_of_generators);
+        slots.resize(sampler.m_number_of_slots * places);
+        for (std::size_t i = number_of_generators;
+             i < sampler.m_number_of_slots; ++i)
+            std::copy_n(slots.begin() + static_cast<std::ptrdiff_t>(
+                                            (i % number_of_generators) *
+                                            places),
+                        places,
+                        slots.begin() +
+                            static_cast<std::ptrdiff_t>(i * places));
+        sampler.m_accumulator.resize(places);
+        for (std::uint32_t i = 0; i < places; ++i)
+            sampler.m_accumulator[i] = i;
+        sampler.m_scratch.resize(places);
+        sampler.m_inverse.resize(places);
+
+        sampler.mix(rng, burn_in);
+        return sampler;
+    }
+
+    std::size_t places() const { return m_places; }
+
+    // Runs `steps` steps without output, e.g. to let a copy of a sampler
+    // diverge from the original with a different generator.
+    void mix(xoshiro256ss &rng, std::size_t steps) {
+        for (std::size_t i = 0; i < steps; ++i)
+            step(rng);
+    }
+
+    // Writes the next random group element into `perm`.
+    template <std::unsigned_integral Entry>
+    void next(std::span<Entry> perm, xoshiro256ss &rng) {
+        assert(perm.size() == m_places);
+        step(rng);
+        convert_into(perm, std::span<const std::uint32_t>{m_accumulator});
+    }
+};
+
+// `count` random elements of the group generated by `generators`, see
+// `product_replacement_sampler`. Every block of samples runs its own copy of
+// the sampler, burnt in with the generator of its stream. Returns
+// std::nullopt for invalid generators.
+template <std::ranges::input_range R>
+[[nodiscard]] std::optional<compact_permutation_arena> sample_group_elements(
+    R &&generators, std::size_t count, std::uint64_t seed,
+    std::size_t number_of_threads = std::thread::hardware_concurrency()) {
+    xoshiro256ss rng{seed};
+    const auto prototype = product_replacement_sampler::create(
+        std::forward<R>(generators), rng, 0zu);
+    if (!prototype)
+        return std::nullopt;
+    compact_permutation_arena samples(prototype->places(), count);
+    samples.visit([&](auto &arena) {
+        for_each_sample_block(
+            count, seed, number_of_threads,
+            [&](std::size_t first, std::size_t last,
+                xoshiro256ss &block_rng) {
+                auto sampler = *prototype;
+                sampler.mix(block_rng,
+                            product_replacement_sampler::default_burn_in);
+                for (std::size_t i = first; i < last; ++i)
+                    sampler.next(arena.slot(i), block_rng);
+            });
+    });
+    return samples;
+}
+
+} // namespace permutations
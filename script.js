@@ -1,8 +1,7 @@
 
 let selected_perms = {}
 
-function handle_click(event){
-    const cell = event.target;
+function handle_click(cell){
     const perm_attr = cell.attributes.getNamedItem("data-perm");
     if(perm_attr != null && perm_attr.value != ""){
         const perm = perm_attr.value;
@@ -23,8 +22,7 @@ function handle_click(event){
     }
 }
 
-function handle_hover(event, enter){
-    const cell = event.target;
+function handle_hover(cell, enter){
     let other_color = "white";
     let this_color = "";
     let header_color = "#aa2222";
@@ -67,17 +65,95 @@ function handle_hover(event, enter){
     }
 }
 
+// Cells of tiles, that are loaded after a click, get the selection, too.
+function apply_selection(root){
+    for(const perm in selected_perms){
+        for(const cell of root.querySelectorAll("." + perm)){
+            cell.classList.add("selected_elm");
+        }
+        for(const sp in selected_perms){
+            for(const crossing_cell of root.querySelectorAll("td.column_"+sp+".row_"+perm)){
+                crossing_cell.classList.add("crossed_cell");
+            }
+        }
+    }
+}
+
+function table_cell(event){
+    if(!(event.target instanceof Element)){
+        return null;
+    }
+    return event.target.closest("td, th");
+}
+
+// One listener per event type on the document instead of three listeners per
+// cell, so that huge tables and tiles, which are loaded later, work the same.
 function add_handlers(){
-    for(const td of document.getElementsByTagName("td")){
-        td.addEventListener("click",handle_click);
-        td.addEventListener("mouseenter",(event)=>handle_hover(event,true));
-        td.addEventListener("mouseleave",(event)=>handle_hover(event,false));
+    document.addEventListener("click", (event)=>{
+        const cell = table_cell(event);
+        if(cell != null){
+            handle_click(cell);
+        }
+    });
+    // "mouseenter" and "mouseleave" do not bubble, so the delegated handlers
+    // have to filter "mouseover" and "mouseout" within the same cell.
+    document.addEventListener("mouseover", (event)=>{
+        const cell = table_cell(event);
+        if(cell != null && !cell.contains(event.relatedTarget)){
+            handle_hover(cell, true);
+        }
+    });
+    document.addEventListener("mouseout", (event)=>{
+        const cell = table_cell(event);
+        if(cell != null && !cell.contains(event.relatedTarget)){
+            handle_hover(cell, false);
+        }
+    });
+}
+
+// Tiled tables (see print_table_tiled) only contain placeholders with a
+// "data-src" attribute. Their content is fetched, when they come near the
+// viewport. A tile, that fails to load, is observed again after a while, so
+// it is retried, when it is still or again near the viewport.
+function load_tiles(){
+    const tiles = document.querySelectorAll(".tile[data-src]");
+    if(tiles.length == 0){
+        return;
     }
-    for(const th of document.getElementsByTagName("th")){
-        th.addEventListener("click",handle_click);
-        th.addEventListener("mouseenter",(event)=>handle_hover(event,true));
-        th.addEventListener("mouseleave",(event)=>handle_hover(event,false));
+    const retry_delay_ms = 2000;
+    let observer = null;
+    const load = (tile)=>{
+        const src = tile.getAttribute("data-src");
+        tile.removeAttribute("data-src");
+        fetch(src)
+            .then((response)=>{
+                // fetch only rejects on network errors, not on 404 or 500
+                if(!response.ok){
+                    throw new Error(src + ": " + response.status);
+                }
+                return response.text();
+            })
+            .then((text)=>{
+                tile.innerHTML = text;
+                apply_selection(tile);
+            })
+            .catch(()=>{
+                tile.setAttribute("data-src", src);
+                setTimeout(()=>observer.observe(tile), retry_delay_ms);
+            });
+    };
+    observer = new IntersectionObserver((entries)=>{
+        for(const entry of entries){
+            if(entry.isIntersecting){
+                observer.unobserve(entry.target);
+                load(entry.target);
+            }
+        }
+    }, {rootMargin: "200px"});
+    for(const tile of tiles){
+        observer.observe(tile);
     }
 }
 
 add_handlers();
+load_tiles();
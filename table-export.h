@@ -0,0 +1,178 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "output-buffer.h"
+#include "tabulated-group.h"
+
+namespace permutations {
+
+// Machine-readable export of a tabulated group. All formats are written in one
+// pass over the product table; every target is optional (nullptr = skip).
+//
+// - elements_csv: `id,label,other_representation,order,cycle_type`, one line
+//   per element; the cycle type is a space separated list of cycle lengths.
+// - table_csv:    the product table as N lines of N comma separated ids, the
+//   cell in line a and column b is the id of a ∘ b.
+// - ndjson:       one JSON object per element and line, with the fields of
+//   elements_csv and the element's row of the product table as "row".
+// - binary:       the product table as raw row-major little-endian matrix of
+//   `tabulation::id_width()` byte wide ids.
+struct table_export_targets {
+    std::FILE *elements_csv{};
+    std::FILE *table_csv{};
+    std::FILE *ndjson{};
+    std::FILE *binary{};
+};
+
+// Writes `text` as JSON string literal including the quotes.
+inline void append_json_string(output_buffer &out, std::string_view text) {
+    static constexpr char hex[] = "0123456789abcdef";
+    out.append('"');
+    for (const char c : text) {
+        const auto u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out.append('\\');
+            out.append(c);
+        } else if (u < 0x20u) {
+            out.append("\\u00");
+            out.append(hex[u >> 4]);
+            out.append(hex[u & 0xfu]);
+        } else {
+            out.append(c);
+        }
+    }
+    out.append('"');
+}
+
+// Writes `text` as CSV field, quoted only if needed.
+inline void append_csv_field(output_buffer &out, std::string_view text) {
+    if (text.find_first_of(",\"\n") == std::string_view::npos) {
+        out.append(text);
+        return;
+    }
+    out.append('"');
+    for (const char c : text) {
+        if (c == '"')
+            out.append('"');
+        out.append(c);
+    }
+    out.append('"');
+}
+
+// `cycle_types` may be empty (then the column stays empty / is null), or hold
+// the cycle lengths of every element by id.
+[[nodiscard]] inline bool
+export_table(const tabulation &table, const table_export_targets &targets,
+             std::span<const std::vector<std::uint32_t>> cycle_types = {}) {
+    const std::uint32_t n = table.order();
+    if (!cycle_types.empty() && cycle_types.size() != n)
+        return false;
+
+    std::optional<output_buffer> elements_csv, table_csv, ndjson, binary;
+    if (targets.elements_csv) {
+        elements_csv.emplace(targets.elements_csv);
+        elements_csv->append(
+            "id,label,other_representation,order,cycle_type\n");
+    }
+    if (targets.table_csv)
+        table_csv.emplace(targets.table_csv);
+    if (targets.ndjson)
+        ndjson.emplace(targets.ndjson);
+    if (targets.binary)
+        binary.emplace(targets.binary);
+
+    const std::size_t width = table.id_width();
+    std::vector<unsigned char> row_bytes(binary ? std::size_t{n} * width
+                                                : 0zu);
+
+    for (std::uint32_t a = 0; a < n; ++a) {
+        std::span<const std::uint32_t> cycle_type{};
+        if (!cycle_types.empty())
+            cycle_type = cycle_types[a];
+
+        if (elements_csv) {
+            auto &out = *elements_csv;
+            out.append_number(a);
+            out.append(',');
+            append_csv_field(out, table.label(a));
+            out.append(',');
+            append_csv_field(out, table.other_representation(a));
+            out.append(',');
+            out.append_number(table.element_order(a));
+            out.append(',');
+            for (std::size_t i = 0; i < cycle_type.size(); ++i) {
+                if (i != 0zu)
+                    out.append(' ');
+                out.append_number(cycle_type[i]);
+            }
+            out.append('\n');
+        }
+
+        if (ndjson) {
+            auto &out = *ndjson;
+            out.append(R"({"id":)");
+            out.append_number(a);
+            out.append(R"(,"label":)");
+            append_json_string(out, table.label(a));
+            out.append(R"(,"other_representation":)");
+            append_json_string(out, table.other_representation(a));
+            out.append(R"(,"order":)");
+            out.append_number(table.element_order(a));
+            out.append(R"(,"cycle_type":)");
+            if (cycle_types.empty()) {
+                out.append("null");
+            } else {
+                out.append('[');
+                for (std::size_t i = 0; i < cycle_type.size(); ++i) {
+                    if (i != 0zu)
+                        out.append(',');
+                    out.append_number(cycle_type[i]);
+                }
+                out.append(']');
+            }
+            out.append(R"(,"row":[)");
+        }
+
+        // the one traversal of the product table feeds all formats
+        for (std::uint32_t b = 0; b < n; ++b) {
+            const std::uint32_t product = table.compose(a, b);
+            if (table_csv) {
+                if (b != 0u)
+                    table_csv->append(',');
+                table_csv->append_number(product);
+            }
+            if (ndjson) {
+                if (b != 0u)
+                    ndjson->append(',');
+                ndjson->append_number(product);
+            }
+            if (binary) {
+                unsigned char *cell =
+                    row_bytes.data() + std::size_t{b} * width;
+                for (std::size_t byte = 0; byte < width; ++byte)
+                    cell[byte] =
+                        static_cast<unsigned char>(product >> (8 * byte));
+            }
+        }
+
+        if (table_csv)
+            table_csv->append('\n');
+        if (ndjson)
+            ndjson->append("]}\n");
+        if (binary)
+            binary->append_bytes(row_bytes.data(), row_bytes.size());
+    }
+
+    bool ok = true;
+    for (auto *out : {&elements_csv, &table_csv, &ndjson, &binary})
+        if (out->has_value() && !(*out)->flush())
+            ok = false;
+    return ok;
+}
+
+} // namespace permutations
@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "group-interface.h"
+
+namespace permutations {
+
+// Regular representation of a finite group: the elements of any
+// `group_config_c` group are enumerated once and get dense ids. The product
+// table, the orders and all strings are computed at that point, so that the
+// `tabulated_group` config below runs every generic algorithm with table
+// lookups instead of the compose and compare functions of the original group.
+
+class tabulation;
+struct tabulated_group;
+
+// An element is its id and its table. `compose_permutations`, `to_string`
+// and the formatter only get elements, not the config, so the element has to
+// lead to the table itself; that makes it 16 bytes instead of 4. The bulk
+// data are bare ids: the product table stores 16 or 32 bit ids, see
+// `tabulation::id_width`.
+struct tabulated_element {
+    std::uint32_t id{};
+    const tabulation *table{};
+
+    constexpr bool operator==(const tabulated_element &other) const {
+        return id == other.id && table == other.table;
+    }
+    inline std::string to_string() const;
+    constexpr explicit operator tabulated_group() const;
+};
+
+inline constexpr auto cmp_tabulated_element = [](tabulated_element a,
+                                                 tabulated_element b) -> bool {
+    return a.id < b.id;
+};
+
+struct tabulated_group {
+    using element_type = tabulated_element;
+    using element_view_type = tabulated_element;
+    using compare_type = decltype(cmp_tabulated_element);
+    const tabulation *table{};
+};
+static_assert(group_config_c<tabulated_group>);
+
+constexpr tabulated_element::operator tabulated_group() const {
+    return tabulated_group{.table = this->table};
+}
+
+class tabulation {
+    std::uint32_t m_order{};
+    std::uint32_t m_identity{};
+    // row-major product table; ids fit into 16 bits for groups up to 65536
+    // elements, which halves the size of the table
+    std::vector<std::uint16_t> m_table16{};
+    std::vector<std::uint32_t> m_table32{};
+    std::vector<std::size_t> m_element_orders{};
+    std::vector<std::string> m_names{};  // `to_string()`
+    std::vector<std::string> m_labels{}; // `std::format("{}", ...)`
+    std::vector<std::string> m_other_representations{};
+
+    tabulation() = default;
+
+  public:
+    // Tabulates the (closed) group `elements`. Returns nullptr, if a product
+    // or the identity is missing from `elements`, or if the composition of
+    // the original group fails. A product table, that is already known, e.g.
+    // from a `group_store`, can be passed as `products`, the ids of a ∘ b in
+    // the order of `elements`; then no products are computed.
+    template <group_config_c G>
+    static std::unique_ptr<const tabulation>
+    create(const group_set<G> &elements, G group_config = G{},
+           std::span<const std::uint32_t> products = {}) {
+        using elm_t = typename G::element_type;
+        using view_t = typename G::element_view_type;
+        using cmp_t = typename G::compare_type;
+        if (elements.empty() ||
+            std::cmp_greater(elements.size(),
+                             std::numeric_limits<std::uint32_t>::max()) ||
+            (!products.empty() &&
+             products.size() != elements.size() * elements.size()))
+            return nullptr;
+
+        // The lookups compare elements, not views, because the compare
+        // types may take their arguments as elements.
+        std::vector<const elm_t *> sorted{};
+        sorted.reserve(elements.size());
+        for (const auto &e : elements)
+            sorted.push_back(&e);
+        auto find = [&](const elm_t &x) -> std::optional<std::uint32_t> {
+            auto it = std::ranges::lower_bound(
+                sorted, x, cmp_t{}, [](const elm_t *e) -> const elm_t & {
+                    return *e;
+                });
+            if (it == sorted.end() || cmp_t{}(x, **it))
+                return std::nullopt;
+            return static_cast<std::uint32_t>(it - sorted.begin());
+        };
+
+        std::unique_ptr<tabulation> t(new tabulation{});
+        const std::size_t n = sorted.size();
+        t->m_order = static_cast<std::uint32_t>(n);
+        const bool narrow = std::cmp_less_equal(
+            n, std::numeric_limits<std::uint16_t>::max() + 1);
+        if (narrow)
+            t->m_table16.resize(n * n);
+        else
+            t->m_table32.resize(n * n);
+
+        const auto identity = get_identity<G>(group_config);
+        auto identity_id = find(identity);
+        if (!identity_id)
+            return nullptr;
+        t->m_identity = *identity_id;
+
+        for (std::size_t a = 0; a < n && !products.empty(); ++a) {
+            for (std::size_t b = 0; b < n; ++b) {
+                const std::uint32_t id = products[a * n + b];
+                if (id >= n)
+                    return nullptr;
+                if (narrow)
+                    t->m_table16[a * n + b] = static_cast<std::uint16_t>(id);
+                else
+                    t->m_table32[a * n + b] = id;
+            }
+        }
+        for (std::size_t a = 0; a < n && products.empty(); ++a) {
+            for (std::size_t b = 0; b < n; ++b) {
+                auto product =
+                    compose_permutations<G>(*sorted[a], *sorted[b]);
+                if (!product)
+                    return nullptr;
+                auto id = find(*product);
+                if (!id)
+                    return nullptr;
+                if (narrow)
+                    t->m_table16[a * n + b] = static_cast<std::uint16_t>(*id);
+                else
+                    t->m_table32[a * n + b] = *id;
+            }
+        }
+
+        t->m_names.reserve(n);
+        t->m_labels.reserve(n);
+        t->m_other_representations.reserve(n);
+        for (const elm_t *element : sorted) {
+            const view_t e = *element;
+            auto other = get_other_representation<G>(e);
+            if (!other)
+                return nullptr;
+            t->m_names.push_back(e.to_string());
+            t->m_labels.push_back(std::format("{}", e));
+            t->m_other_representations.push_back(std::move(*other));
+        }
+
+        t->m_element_orders.resize(n);
+        for (std::uint32_t x = 0; x < n; ++x) {
+            std::size_t order = 1;
+            for (std::uint32_t p = x; p != t->m_identity;
+                 p = t->compose(x, p)) {
+                ++order;
+                if (order > n)
+                    return nullptr;
+            }
+            t->m_element_orders[x] = order;
+        }
+        return t;
+    }
+
+    constexpr std::uint32_t order() const { return m_order; }
+    constexpr tabulated_group config() const {
+        return tabulated_group{.table = this};
+    }
+    constexpr tabulated_element identity() const {
+        return tabulated_element{.id = m_identity, .table = this};
+    }
+    constexpr tabulated_element element(std::uint32_t id) const {
+        assert(id < m_order);
+        return tabulated_element{.id = id, .table = this};
+    }
+    // all elements in the order of the original group
+    std::vector<tabulated_element> elements() const {
+        std::vector<tabulated_element> ret(m_order);
+        for (std::uint32_t id = 0; id < m_order; ++id)
+            ret[id] = element(id);
+        return ret;
+    }
+
+    // size of the ids in the product table in bytes
+    constexpr std::size_t id_width() const {
+        return m_table16.empty() ? sizeof(std::uint32_t)
+                                 : sizeof(std::uint16_t);
+    }
+
+    std::uint32_t compose(std::uint32_t a, std::uint32_t b) const {
+        assert(a < m_order && b < m_order);
+        const std::size_t cell = std::size_t{a} * m_order + b;
+        if (!m_table16.empty())
+            return m_table16[cell];
+        return m_table32[cell];
+    }
+    std::size_t element_order(std::uint32_t id) const {
+        return m_element_orders[id];
+    }
+    const std::string &name(std::uint32_t id) const { return m_names[id]; }
+    const std::string &label(std::uint32_t id) const { return m_labels[id]; }
+    const std::string &other_representation(std::uint32_t id) const {
+        return m_other_representations[id];
+    }
+};
+
+inline std::string tabulated_element::to_string() const {
+    return table->name(id);
+}
+
+template <>
+inline typename tabulated_group::element_type
+get_identity<tabulated_group>(tabulated_group g) {
+    return g.table->identity();
+}
+
+template <>
+inline std::optional<tabulated_element>
+compose_permutations<tabulated_group>(tabulated_element a,
+                                      tabulated_element b) {
+    if (a.table != b.table)
+        return std::nullopt;
+    return a.table->element(a.table->compose(a.id, b.id));
+}
+
+template <>
+inline std::optional<std::string>
+get_other_representation<tabulated_group>(tabulated_element e) {
+    return e.table->other_representation(e.id);
+}
+
+} // namespace permutations
+
+template <> struct std::formatter<permutations::tabulated_element, char> {
+
+    unsigned repr_a : 1 = 0;
+    unsigned repr_b : 1 = 0;
+
+    template <class ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext &ctx) {
+
+        auto it = ctx.begin();
+        for (; it != ctx.end(); it++) {
+            char c = *it;
+            switch (c) {
+            case 'a':
+                repr_a = true;
+                break;
+
+            case 'b':
+                repr_b = true;
+                break;
+
+            case '}':
+                return it;
+
+            default:
+                throw std::format_error(
+                    "Invalid format args for tabulated_element.");
+            }
+        }
+        return it;
+    }
+
+    template <typename FmtContext>
+    FmtContext::iterator format(const permutations::tabulated_element &e,
+                                FmtContext &ctx) const {
+        bool repr_a = this->repr_a;
+        bool repr_b = this->repr_b;
+        if (!repr_a && !repr_b)
+            repr_a = true;
+
+        auto out = ctx.out();
+        if (repr_a)
+            out = std::ranges::copy(e.table->label(e.id), out).out;
+        if (repr_a && repr_b)
+            out = std::ranges::copy(std::string_view{" - "}, out).out;
+        if (repr_b)
+            out = std::ranges::copy(e.table->other_representation(e.id), out)
+                      .out;
+        return out;
+    }
+};
+static_assert(std::formattable<permutations::tabulated_element, char>);